@@ -0,0 +1,460 @@
+/* ------------------------------------------------------------ */
+/*                 Render Benchmark (on-board)                  */
+/* ------------------------------------------------------------ */
+#include "bench.h"
+#include "damage.h"
+#include "sprite_cache.h"
+#include "plant_tiles.h"
+#include "fb_memory.h"
+#include "render_bands.h"
+#include "xparameters.h"
+#include "xtime_l.h"
+#include <stdio.h>
+#include <string.h>
+
+// Kept static: GameState is too large for the 8KB stack
+static GameState original_state;
+static GameState saved_state;
+
+static const char *mode_names[] = { "rects", "tiles" };
+
+// Assets live in pvz_game.c (image headers can only be included once)
+extern const unsigned char gImage_Sun[];
+extern const unsigned char gImage_ProjectilePea[];
+extern const unsigned char gImage_SunBank[];
+extern const unsigned char gImage_SeedBank[];
+extern const unsigned char gImage_PeaShooter_ani[];
+extern const unsigned char gImage_SunFlower_ani[];
+extern const unsigned char gImage_walk_ani[];
+extern const unsigned char gImage_bite_ani[];
+
+typedef enum {
+    ASSET_SUN,
+    ASSET_PEA,
+    ASSET_SUNBANK,
+    ASSET_SEEDBANK,
+    ASSET_PEASHOOTER,
+    ASSET_SUNFLOWER,
+    ASSET_WALK,
+    ASSET_BITE,
+    NUM_BENCH_ASSETS
+} BenchAsset;
+
+static const char *asset_names[NUM_BENCH_ASSETS] = {
+    "Sun", "ProjectilePea", "SunBank", "SeedBank",
+    "PeaShooter_ani", "SunFlower_ani", "walk_ani", "bite_ani"
+};
+
+/**
+ * Fill the lawn and spawn zombies so every layer has work each frame
+ */
+static void bench_seed_scene(GameState *game)
+{
+    int row, col, i;
+
+    for (row = 0; row < GRID_ROWS; row++) {
+        for (col = 0; col < GRID_COLS; col++) {
+            game_set_plant(game, row, col, (col < 2) ? PLANT_SUNFLOWER : PLANT_PEASHOOTER);
+            game->grid[row][col].animation_frame = (row + col) % 4;
+        }
+    }
+
+    for (i = 0; i < MAX_ZOMBIES; i++)
+        game_spawn_zombie(game);
+}
+
+/**
+ * Advance one fixed-timestep tick, same update order as the main loop
+ */
+static void bench_update(GameState *game)
+{
+    game_begin_tick(game);
+    game_update_animation(game);
+    game_check_pea_zombie_collision(game);
+    game_update_peas(game);
+    game_update_suns(game);
+    game_update_zombies(game);
+}
+
+/**
+ * Run BENCH_TICKS ticks with one damage mode, timing only the render:
+ * back buffer sync, damage, composition and cache flush
+ */
+static void bench_run_mode(GameState *game, u8 **frames, int num_frames, DamageMode mode)
+{
+    XTime t0, t1;
+    u64 total = 0, worst = 0;
+    u64 sync_bytes = 0, flush_bytes = 0;
+    int front = 0, back;
+    int i, frame;
+
+    damage_set_mode(mode);
+
+    *game = saved_state;
+    for (i = 0; i < num_frames; i++)
+        game_draw_full(game, frames[i]);
+    damage_init(num_frames);
+
+    for (frame = 0; frame < BENCH_TICKS; frame++) {
+        back = (front + 1) % num_frames;
+
+        bench_update(game);
+
+        XTime_GetTime(&t0);
+
+        damage_begin_frame(back);
+        damage_sync_back_buffer(frames[back], frames[front], back);
+        game_damage_changes(game);
+        game_draw_damage(game, frames[back]);
+        damage_flush_frame(frames[back]);
+        damage_end_frame(1);
+
+        XTime_GetTime(&t1);
+
+        total += t1 - t0;
+        if (t1 - t0 > worst) worst = t1 - t0;
+        sync_bytes += damage_last_sync_bytes();
+        flush_bytes += damage_last_flush_bytes();
+
+        front = back;
+    }
+
+    printf("  %-6s avg %6llu us  max %6llu us  sync %7llu B/frame  flush %7llu B/frame\n",
+           mode_names[mode],
+           (unsigned long long)(total * 1000000 / COUNTS_PER_SECOND / BENCH_TICKS),
+           (unsigned long long)(worst * 1000000 / COUNTS_PER_SECOND),
+           (unsigned long long)(sync_bytes / BENCH_TICKS),
+           (unsigned long long)(flush_bytes / BENCH_TICKS));
+}
+
+/**
+ * Draw one asset through the normal draw functions
+ * Animated assets cycle through their frames.
+ */
+static void bench_draw_asset(u8 *framebuf, BenchAsset asset, int n)
+{
+    switch (asset) {
+        case ASSET_SUN:
+            draw_sprite_transparent(framebuf, 300, 200, gImage_Sun, SUN_SIZE, SUN_SIZE, NULL);
+            break;
+        case ASSET_PEA:
+            draw_sprite_transparent(framebuf, 300, 200, gImage_ProjectilePea, PEA_SIZE, PEA_SIZE, NULL);
+            break;
+        case ASSET_SUNBANK:
+            draw_sprite_transparent(framebuf, SUNBANK_X, SUNBANK_Y, gImage_SunBank, 63, 70, NULL);
+            break;
+        case ASSET_SEEDBANK:
+            draw_sprite_transparent(framebuf, SEEDBANK_X, SEEDBANK_Y, gImage_SeedBank,
+                                    SEEDBANK_DRAW_WIDTH, SEEDBANK_DRAW_HEIGHT, NULL);
+            break;
+        case ASSET_PEASHOOTER:
+            draw_sprite_from_sheet(framebuf, 300, 200, PLANT_SIZE, PLANT_SIZE,
+                                   gImage_PeaShooter_ani, n % ANIMATION_FRAMES, NULL);
+            break;
+        case ASSET_SUNFLOWER:
+            draw_sprite_from_sheet(framebuf, 300, 200, PLANT_SIZE, PLANT_SIZE,
+                                   gImage_SunFlower_ani, n % ANIMATION_FRAMES, NULL);
+            break;
+        case ASSET_WALK:
+            draw_zombie_sprite(framebuf, 400, 250, gImage_walk_ani, n % (ZOMBIE_ROWS * ZOMBIE_COLS), NULL);
+            break;
+        case ASSET_BITE:
+            draw_bite_sprite(framebuf, 400, 250, gImage_bite_ani, n % BITE_ANIMATION_FRAMES, NULL);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * Average CPU cycles per draw of one asset
+ */
+static u32 bench_time_asset(u8 *framebuf, BenchAsset asset)
+{
+    XTime t0, t1;
+    int n;
+
+    XTime_GetTime(&t0);
+    for (n = 0; n < BENCH_SPRITE_DRAWS; n++)
+        bench_draw_asset(framebuf, asset, n);
+    XTime_GetTime(&t1);
+
+    return (u32)((t1 - t0) * (XPAR_CPU_CORTEXA9_0_CPU_CLK_FREQ_HZ / COUNTS_PER_SECOND) /
+                 BENCH_SPRITE_DRAWS);
+}
+
+void bench_sprite_formats(u8 *framebuf)
+{
+    int asset;
+
+    printf("\n==== Sprite format benchmark: %d draws each ====\n", BENCH_SPRITE_DRAWS);
+    printf("  %-15s %10s %10s\n", "asset", "per-pixel", "RLE");
+
+    for (asset = 0; asset < NUM_BENCH_ASSETS; asset++) {
+        u32 plain, rle;
+
+        sprite_cache_set_rle(0);
+        plain = bench_time_asset(framebuf, asset);
+        sprite_cache_set_rle(1);
+        rle = bench_time_asset(framebuf, asset);
+
+        printf("  %-15s %10u %10u cycles\n", asset_names[asset], (unsigned)plain, (unsigned)rle);
+    }
+    printf("  RLE pool: %u bytes\n", (unsigned)rle_pool_used());
+    printf("==============================================\n\n");
+}
+
+void bench_render_modes(GameState *game, u8 **frames, int num_frames)
+{
+    DamageMode old_mode = damage_get_mode();
+
+    original_state = *game;
+    saved_state = *game;
+    bench_seed_scene(&saved_state);
+
+    printf("\n==== Render benchmark: %d ticks, %d buffers ====\n", BENCH_TICKS, num_frames);
+    bench_run_mode(game, frames, num_frames, DAMAGE_MODE_RECTS);
+    bench_run_mode(game, frames, num_frames, DAMAGE_MODE_TILES);
+    printf("==============================================\n\n");
+
+    // Leave the game exactly as we found it
+    *game = original_state;
+    damage_set_mode(old_mode);
+}
+
+/* ============================================================ */
+/*                  FRAME TIME HISTOGRAM                        */
+/* ============================================================ */
+
+static u32 frame_hist[BENCH_HIST_BUCKETS];
+static u32 frame_hist_count = 0;
+static u64 frame_hist_worst = 0;
+
+static void hist_clear(void)
+{
+    memset(frame_hist, 0, sizeof(frame_hist));
+    frame_hist_count = 0;
+    frame_hist_worst = 0;
+}
+
+/**
+ * Count one frame time; the last bucket collects everything longer
+ */
+static void hist_add(u64 counts)
+{
+    u64 us = counts * 1000000 / COUNTS_PER_SECOND;
+    u64 bucket = us / BENCH_HIST_BUCKET_US;
+
+    frame_hist[(bucket < BENCH_HIST_BUCKETS) ? bucket : BENCH_HIST_BUCKETS - 1]++;
+    frame_hist_count++;
+    if (counts > frame_hist_worst) frame_hist_worst = counts;
+}
+
+/**
+ * Frame time (us, bucket upper edge) that pct percent of frames stay within
+ * Never more than the slowest frame actually seen.
+ */
+static u32 hist_percentile(int pct)
+{
+    u32 need = (frame_hist_count * pct + 99) / 100;
+    u32 worst_us = (u32)(frame_hist_worst * 1000000 / COUNTS_PER_SECOND);
+    u32 seen = 0;
+    int b;
+
+    for (b = 0; b < BENCH_HIST_BUCKETS - 1; b++) {
+        seen += frame_hist[b];
+        if (seen >= need)
+            break;
+    }
+    return ((u32)(b + 1) * BENCH_HIST_BUCKET_US < worst_us) ? (u32)(b + 1) * BENCH_HIST_BUCKET_US : worst_us;
+}
+
+/**
+ * Print the percentiles and one bar per non-empty bucket
+ */
+static void hist_report(const char *name)
+{
+    u32 largest = 1;
+    int b, i;
+
+    printf("  %-10s p50 %5lu us  p90 %5lu us  p99 %5lu us  max %5llu us\n", name,
+           (unsigned long)hist_percentile(50), (unsigned long)hist_percentile(90),
+           (unsigned long)hist_percentile(99),
+           (unsigned long long)(frame_hist_worst * 1000000 / COUNTS_PER_SECOND));
+
+    for (b = 0; b < BENCH_HIST_BUCKETS; b++) {
+        if (frame_hist[b] > largest) largest = frame_hist[b];
+    }
+    for (b = 0; b < BENCH_HIST_BUCKETS; b++) {
+        if (!frame_hist[b])
+            continue;
+        printf("    <%5d us %5lu ", (b + 1) * BENCH_HIST_BUCKET_US, (unsigned long)frame_hist[b]);
+        for (i = 0; i < (int)(frame_hist[b] * 40 / largest); i++)
+            putchar('#');
+        putchar('\n');
+    }
+}
+
+/* ============================================================ */
+/*                BANDED RENDERING (BOTH CORES)                 */
+/* ============================================================ */
+
+/**
+ * Average counts per full redraw of the seeded scene
+ */
+static u64 bench_full_frames(GameState *game, u8 **frames, int num_frames)
+{
+    XTime t0, t1;
+    int i;
+
+    *game = saved_state;
+    XTime_GetTime(&t0);
+    for (i = 0; i < BENCH_BAND_FULL_FRAMES; i++)
+        game_draw_full(game, frames[i % num_frames]);
+    XTime_GetTime(&t1);
+
+    return (t1 - t0) / BENCH_BAND_FULL_FRAMES;
+}
+
+/**
+ * Average counts per incremental frame over BENCH_TICKS ticks:
+ * back buffer sync, damage, composition and cache flush
+ * Every frame time also goes into the histogram.
+ */
+static u64 bench_incremental_frames(GameState *game, u8 **frames, int num_frames)
+{
+    XTime t0, t1;
+    u64 total = 0;
+    int front = 0, back;
+    int i, frame;
+
+    *game = saved_state;
+    for (i = 0; i < num_frames; i++)
+        game_draw_full(game, frames[i]);
+    damage_init(num_frames);
+
+    for (frame = 0; frame < BENCH_TICKS; frame++) {
+        back = (front + 1) % num_frames;
+
+        bench_update(game);
+
+        XTime_GetTime(&t0);
+        damage_begin_frame(back);
+        damage_sync_back_buffer(frames[back], frames[front], back);
+        game_damage_changes(game);
+        game_draw_damage(game, frames[back]);
+        damage_flush_frame(frames[back]);
+        damage_end_frame(1);
+        XTime_GetTime(&t1);
+
+        total += t1 - t0;
+        hist_add(t1 - t0);
+        front = back;
+    }
+
+    return total / BENCH_TICKS;
+}
+
+void bench_band_render(GameState *game, u8 **frames, int num_frames)
+{
+    int was_enabled = bands_enabled();
+    u64 full[2], incremental[2];
+    int banded;
+
+    original_state = *game;
+    saved_state = *game;
+    bench_seed_scene(&saved_state);
+
+    for (banded = 0; banded < 2; banded++) {
+        bands_set_enabled(banded);
+        full[banded] = bench_full_frames(game, frames, num_frames);
+        incremental[banded] = bench_incremental_frames(game, frames, num_frames);
+    }
+
+    printf("\n==== Band rendering: %d bands, %d full frames, %d ticks ====\n",
+           BANDS_NUM, BENCH_BAND_FULL_FRAMES, BENCH_TICKS);
+    printf("  full         one core %6llu us  both cores %6llu us  speedup %3llu.%02llux\n",
+           (unsigned long long)(full[0] * 1000000 / COUNTS_PER_SECOND),
+           (unsigned long long)(full[1] * 1000000 / COUNTS_PER_SECOND),
+           (unsigned long long)(full[0] / full[1]),
+           (unsigned long long)(full[0] * 100 / full[1] % 100));
+    printf("  incremental  one core %6llu us  both cores %6llu us  speedup %3llu.%02llux\n",
+           (unsigned long long)(incremental[0] * 1000000 / COUNTS_PER_SECOND),
+           (unsigned long long)(incremental[1] * 1000000 / COUNTS_PER_SECOND),
+           (unsigned long long)(incremental[0] / incremental[1]),
+           (unsigned long long)(incremental[0] * 100 / incremental[1] % 100));
+    printf("==============================================\n\n");
+
+    // Leave the game exactly as we found it
+    *game = original_state;
+    bands_set_enabled(was_enabled);
+}
+
+/* ============================================================ */
+/*                STAGGERED PLANT ANIMATION                     */
+/* ============================================================ */
+
+void bench_anim_stagger(GameState *game, u8 **frames, int num_frames)
+{
+    u64 avg;
+
+    original_state = *game;
+    saved_state = *game;
+    bench_seed_scene(&saved_state);
+
+    printf("\n==== Plant animation: frame time over %d ticks ====\n", BENCH_TICKS);
+
+    game_set_anim_stagger(0);
+    hist_clear();
+    avg = bench_incremental_frames(game, frames, num_frames);
+    printf("  lockstep   avg %5llu us\n", (unsigned long long)(avg * 1000000 / COUNTS_PER_SECOND));
+    hist_report("lockstep");
+
+    game_set_anim_stagger(1);
+    hist_clear();
+    avg = bench_incremental_frames(game, frames, num_frames);
+    printf("  staggered  avg %5llu us\n", (unsigned long long)(avg * 1000000 / COUNTS_PER_SECOND));
+    hist_report("staggered");
+    printf("==============================================\n\n");
+
+    // Leave the game exactly as we found it
+    *game = original_state;
+}
+
+/* ============================================================ */
+/*             FRAMEBUFFER MEMORY MODE (MAIN LOOP)              */
+/* ============================================================ */
+
+static u64 fb_mem_render = 0, fb_mem_present = 0;
+static u64 fb_mem_render_worst = 0, fb_mem_present_worst = 0;
+static int fb_mem_frames = 0;
+
+/**
+ * Account one presented frame; report and switch mode every BENCH_FB_MEM_FRAMES
+ */
+void bench_fb_memory_frame(u64 render_counts, u64 present_counts)
+{
+    FbMemMode mode = fbmem_get_mode();
+
+    fb_mem_render += render_counts;
+    fb_mem_present += present_counts;
+    if (render_counts > fb_mem_render_worst) fb_mem_render_worst = render_counts;
+    if (present_counts > fb_mem_present_worst) fb_mem_present_worst = present_counts;
+
+    if (++fb_mem_frames < BENCH_FB_MEM_FRAMES)
+        return;
+
+    printf("  fb %-6s render avg %6llu us max %6llu us  present avg %6llu us max %6llu us\n",
+           fbmem_mode_name(mode),
+           (unsigned long long)(fb_mem_render * 1000000 / COUNTS_PER_SECOND / fb_mem_frames),
+           (unsigned long long)(fb_mem_render_worst * 1000000 / COUNTS_PER_SECOND),
+           (unsigned long long)(fb_mem_present * 1000000 / COUNTS_PER_SECOND / fb_mem_frames),
+           (unsigned long long)(fb_mem_present_worst * 1000000 / COUNTS_PER_SECOND));
+    plant_tile_report();
+
+    fb_mem_render = fb_mem_present = 0;
+    fb_mem_render_worst = fb_mem_present_worst = 0;
+    fb_mem_frames = 0;
+
+    fbmem_set_mode((FbMemMode)((mode + 1) % FB_MEM_NUM_MODES));
+}
@@ -0,0 +1,65 @@
+/* ------------------------------------------------------------ */
+/*                 Render Benchmark (on-board)                  */
+/* ------------------------------------------------------------ */
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "xil_types.h"
+#include "pvz_game.h"
+
+/* Simulated ticks rendered per benchmark run */
+#define BENCH_TICKS          600
+
+/**
+ * Render the same seeded scene with every damage mode and print
+ * per-frame render time and bytes touched.
+ * The game state is left exactly as it was passed in; the framebuffers
+ * are overwritten, so call this before the initial full draw.
+ */
+void bench_render_modes(GameState *game, u8 **frames, int num_frames);
+
+/* Draws per asset and blitter in the sprite format benchmark */
+#define BENCH_SPRITE_DRAWS   200
+
+/**
+ * Time every transparent asset with the per-pixel blitters and with
+ * the RLE blitter and print cycles per draw.
+ * Needs the sprite cache initialized; draws into framebuf.
+ */
+void bench_sprite_formats(u8 *framebuf);
+
+/* Full redraws timed per configuration in the band benchmark */
+#define BENCH_BAND_FULL_FRAMES  60
+
+/**
+ * Time full and incremental frames of the seeded scene composed by one
+ * core and in bands by both cores, and print the speedup.
+ * Needs the other core running bands_help. Overwrites the framebuffers
+ * and restarts the damage history: call before the initial full draw.
+ */
+void bench_band_render(GameState *game, u8 **frames, int num_frames);
+
+/* Frame time histogram: bucket width and count (last bucket is open-ended) */
+#define BENCH_HIST_BUCKET_US 100
+#define BENCH_HIST_BUCKETS   100
+
+/**
+ * Time incremental frames of the seeded scene with every plant
+ * advancing on the same tick and with staggered phases, and print the
+ * frame time percentiles and histogram of each.
+ * Overwrites the framebuffers: call before the initial full draw.
+ */
+void bench_anim_stagger(GameState *game, u8 **frames, int num_frames);
+
+/* Presented frames per framebuffer memory mode in the main-loop benchmark */
+#define BENCH_FB_MEM_FRAMES  600
+
+/**
+ * Main-loop benchmark: account one presented frame's render and present
+ * time (timer counts). Every BENCH_FB_MEM_FRAMES frames the averages for
+ * the current framebuffer memory mode are printed and the next mode is
+ * mapped, so a long run reports every mode under real gameplay.
+ */
+void bench_fb_memory_frame(u64 render_counts, u64 present_counts);
+
+#endif // BENCH_H
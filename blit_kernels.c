@@ -0,0 +1,238 @@
+/* ------------------------------------------------------------ */
+/*              Pixel Row Kernels (NEON / scalar)               */
+/* ------------------------------------------------------------ */
+#include "blit_kernels.h"
+#include <stdio.h>
+#include <string.h>
+#if KERN_HAVE_NEON
+#include <arm_neon.h>
+#endif
+
+/* ============================================================ */
+/*                     Scalar Reference                         */
+/* ============================================================ */
+
+static void scalar_copy_row(u8 *dst, const u8 *src, int npix)
+{
+    memcpy(dst, src, npix * 3);
+}
+
+static void scalar_key_copy_row(u8 *dst, const u8 *src, int npix, int key)
+{
+    int j;
+
+    for (j = 0; j < npix; j++, dst += 3, src += 3) {
+        if ((int)src[0] + (int)src[1] + (int)src[2] < key)
+            continue;
+        dst[0] = src[0];
+        dst[1] = src[1];
+        dst[2] = src[2];
+    }
+}
+
+static void darken_bytes(u8 *dst, const u8 *src, int nbytes)
+{
+    int j;
+
+    for (j = 0; j < nbytes; j++)
+        dst[j] = src[j] / 2;
+}
+
+static void scalar_darken_row(u8 *dst, const u8 *src, int npix)
+{
+    darken_bytes(dst, src, npix * 3);
+}
+
+static void scalar_scale_bytes(u8 *buf, int nbytes, int mul)
+{
+    int j;
+
+    for (j = 0; j < nbytes; j++)
+        buf[j] = (u8)((buf[j] * mul) >> 8);
+}
+
+const BlitKernels kern_scalar = {
+    "scalar",
+    scalar_copy_row,
+    scalar_key_copy_row,
+    scalar_darken_row,
+    scalar_scale_bytes
+};
+
+/* ============================================================ */
+/*                          NEON                                */
+/* ============================================================ */
+#if KERN_HAVE_NEON
+
+static void neon_copy_row(u8 *dst, const u8 *src, int npix)
+{
+    int n = npix * 3;
+
+    // 64 bytes per iteration
+    for (; n >= 64; n -= 64, src += 64, dst += 64) {
+        uint8x16_t a = vld1q_u8(src);
+        uint8x16_t b = vld1q_u8(src + 16);
+        uint8x16_t c = vld1q_u8(src + 32);
+        uint8x16_t d = vld1q_u8(src + 48);
+        vst1q_u8(dst, a);
+        vst1q_u8(dst + 16, b);
+        vst1q_u8(dst + 32, c);
+        vst1q_u8(dst + 48, d);
+    }
+    for (; n >= 16; n -= 16, src += 16, dst += 16)
+        vst1q_u8(dst, vld1q_u8(src));
+
+    memcpy(dst, src, n);
+}
+
+static void neon_key_copy_row(u8 *dst, const u8 *src, int npix, int key)
+{
+    uint16x8_t key16 = vdupq_n_u16((u16)key);
+
+    // 16 pixels per iteration, deinterleaved into B, G, R planes
+    for (; npix >= 16; npix -= 16, src += 48, dst += 48) {
+        uint8x16x3_t s = vld3q_u8(src);
+        uint8x16x3_t d = vld3q_u8(dst);
+
+        uint16x8_t sum_lo = vaddw_u8(vaddl_u8(vget_low_u8(s.val[0]), vget_low_u8(s.val[1])),
+                                     vget_low_u8(s.val[2]));
+        uint16x8_t sum_hi = vaddw_u8(vaddl_u8(vget_high_u8(s.val[0]), vget_high_u8(s.val[1])),
+                                     vget_high_u8(s.val[2]));
+
+        // 0xFF where the source pixel is transparent (keep dst)
+        uint8x16_t keep = vcombine_u8(vmovn_u16(vcltq_u16(sum_lo, key16)),
+                                      vmovn_u16(vcltq_u16(sum_hi, key16)));
+
+        d.val[0] = vbslq_u8(keep, d.val[0], s.val[0]);
+        d.val[1] = vbslq_u8(keep, d.val[1], s.val[1]);
+        d.val[2] = vbslq_u8(keep, d.val[2], s.val[2]);
+        vst3q_u8(dst, d);
+    }
+
+    scalar_key_copy_row(dst, src, npix, key);
+}
+
+static void neon_darken_row(u8 *dst, const u8 *src, int npix)
+{
+    int n = npix * 3;
+
+    for (; n >= 16; n -= 16, src += 16, dst += 16)
+        vst1q_u8(dst, vshrq_n_u8(vld1q_u8(src), 1));
+
+    darken_bytes(dst, src, n);
+}
+
+static void neon_scale_bytes(u8 *buf, int nbytes, int mul)
+{
+    uint8x8_t m = vdup_n_u8((u8)mul);
+
+    for (; nbytes >= 16; nbytes -= 16, buf += 16) {
+        uint8x16_t v = vld1q_u8(buf);
+        uint8x8_t lo = vshrn_n_u16(vmull_u8(vget_low_u8(v), m), 8);
+        uint8x8_t hi = vshrn_n_u16(vmull_u8(vget_high_u8(v), m), 8);
+        vst1q_u8(buf, vcombine_u8(lo, hi));
+    }
+
+    scalar_scale_bytes(buf, nbytes, mul);
+}
+
+const BlitKernels kern_neon = {
+    "neon",
+    neon_copy_row,
+    neon_key_copy_row,
+    neon_darken_row,
+    neon_scale_bytes
+};
+
+#endif // KERN_HAVE_NEON
+
+/* ============================================================ */
+/*                  Dispatch and Self Test                      */
+/* ============================================================ */
+
+const BlitKernels *kern = &kern_scalar;
+
+// Scratch rows for the self test (static: stack is only 8KB)
+#define TEST_PIX  203       // not a multiple of 16, exercises the tails
+static u8 test_src[TEST_PIX * 3];
+static u8 test_ref[TEST_PIX * 3];
+static u8 test_out[TEST_PIX * 3];
+
+/**
+ * Deterministic test pattern with plenty of black and near-black pixels
+ */
+static void fill_test_pattern(u8 *buf, int nbytes, u32 seed)
+{
+    int j;
+
+    for (j = 0; j < nbytes; j++) {
+        seed = seed * 1103515245u + 12345u;
+        buf[j] = (u8)(seed >> 16);
+        if ((seed >> 28) < 6)
+            buf[j] &= 0x0F;     // bias towards dark pixels
+        if ((seed >> 28) == 6)
+            buf[j] = 0;
+    }
+}
+
+int kern_self_test(const BlitKernels *impl)
+{
+    static const int keys[] = { KERN_KEY_BLACK, KERN_KEY_NEAR_BLACK };
+    static const int muls[] = { 0, 1, 128, 200, 255 };
+    int errors = 0;
+    int npix, k, m;
+
+    // Every length from 0 to TEST_PIX, so each tail size is hit
+    for (npix = 0; npix <= TEST_PIX; npix++) {
+        int nbytes = npix * 3;
+
+        fill_test_pattern(test_src, nbytes, npix);
+
+        fill_test_pattern(test_ref, nbytes, npix + 1000);
+        memcpy(test_out, test_ref, nbytes);
+        kern_scalar.copy_row(test_ref, test_src, npix);
+        impl->copy_row(test_out, test_src, npix);
+        errors += memcmp(test_ref, test_out, nbytes) != 0;
+
+        for (k = 0; k < 2; k++) {
+            fill_test_pattern(test_ref, nbytes, npix + 2000);
+            memcpy(test_out, test_ref, nbytes);
+            kern_scalar.key_copy_row(test_ref, test_src, npix, keys[k]);
+            impl->key_copy_row(test_out, test_src, npix, keys[k]);
+            errors += memcmp(test_ref, test_out, nbytes) != 0;
+        }
+
+        kern_scalar.darken_row(test_ref, test_src, npix);
+        impl->darken_row(test_out, test_src, npix);
+        errors += memcmp(test_ref, test_out, nbytes) != 0;
+
+        for (m = 0; m < 5; m++) {
+            memcpy(test_ref, test_src, nbytes);
+            memcpy(test_out, test_src, nbytes);
+            kern_scalar.scale_bytes(test_ref, nbytes, muls[m]);
+            impl->scale_bytes(test_out, nbytes, muls[m]);
+            errors += memcmp(test_ref, test_out, nbytes) != 0;
+        }
+    }
+
+    return errors;
+}
+
+void kern_init(void)
+{
+    kern = &kern_scalar;
+
+#if KERN_HAVE_NEON
+    {
+        int errors = kern_self_test(&kern_neon);
+
+        if (errors == 0) {
+            kern = &kern_neon;
+        } else {
+            printf("WARNING: NEON kernels differ from scalar in %d cases - using scalar\n", errors);
+        }
+    }
+#endif
+
+    printf("INFO: Pixel kernels: %s\n", kern->name);
+}
@@ -0,0 +1,50 @@
+/* ------------------------------------------------------------ */
+/*              Pixel Row Kernels (NEON / scalar)               */
+/* ------------------------------------------------------------ */
+#ifndef BLIT_KERNELS_H
+#define BLIT_KERNELS_H
+
+#include "xil_types.h"
+
+/* NEON is used when the compiler targets it (-mfpu=neon) unless disabled */
+#if (defined(__ARM_NEON) || defined(__ARM_NEON__)) && !defined(PVZ_NO_NEON)
+#define KERN_HAVE_NEON  1
+#else
+#define KERN_HAVE_NEON  0
+#endif
+
+/* Color key thresholds: pixel is transparent if b + g + r < key */
+#define KERN_KEY_BLACK       1      /* exact (0,0,0) */
+#define KERN_KEY_NEAR_BLACK  30
+
+/* One implementation of every row kernel (BGR888, npix pixels) */
+typedef struct {
+    const char *name;
+    void (*copy_row)(u8 *dst, const u8 *src, int npix);
+    void (*key_copy_row)(u8 *dst, const u8 *src, int npix, int key);
+    void (*darken_row)(u8 *dst, const u8 *src, int npix);
+    void (*scale_bytes)(u8 *buf, int nbytes, int mul);    /* buf = buf * mul >> 8, mul 0..255 */
+} BlitKernels;
+
+/* Active implementation - call through this */
+extern const BlitKernels *kern;
+
+extern const BlitKernels kern_scalar;
+#if KERN_HAVE_NEON
+extern const BlitKernels kern_neon;
+#endif
+
+/**
+ * Pick the fastest implementation available
+ * With NEON, it is only selected if kern_self_test passes.
+ */
+void kern_init(void);
+
+/**
+ * Run every kernel of impl and of the scalar reference on the same
+ * inputs and compare the outputs byte for byte
+ * Returns the number of mismatching cases (0 = identical).
+ */
+int kern_self_test(const BlitKernels *impl);
+
+#endif // BLIT_KERNELS_H
@@ -0,0 +1,190 @@
+/* ------------------------------------------------------------ */
+/*              Clip Regions and Per-Row Draw Spans             */
+/* ------------------------------------------------------------ */
+#include "clip.h"
+#include "pvz_game.h"
+#include <stdio.h>
+
+static ClipRegion screen_region;
+static ClipRegion ui_protected_region;
+static int regions_ready = 0;
+
+static void clip_init_shared(void)
+{
+    if (regions_ready) return;
+
+    clip_region_init(&screen_region, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+    clip_region_protect_ui(&ui_protected_region, &screen_region);
+    regions_ready = 1;
+}
+
+void clip_region_init(ClipRegion *region, int x, int y, int w, int h)
+{
+    region->bounds.x = x;
+    region->bounds.y = y;
+    region->bounds.w = w;
+    region->bounds.h = h;
+    region->num_exclude = 0;
+}
+
+void clip_region_exclude(ClipRegion *region, int x, int y, int w, int h)
+{
+    ClipRect *r;
+
+    if (w <= 0 || h <= 0) return;
+
+    if (region->num_exclude >= CLIP_MAX_EXCLUDE) {
+        printf("WARNING: clip region exclusion list full\n");
+        return;
+    }
+
+    r = &region->exclude[region->num_exclude++];
+    r->x = x;
+    r->y = y;
+    r->w = w;
+    r->h = h;
+}
+
+const ClipRegion *clip_screen(void)
+{
+    clip_init_shared();
+    return &screen_region;
+}
+
+const ClipRegion *clip_ui_protected(void)
+{
+    clip_init_shared();
+    return &ui_protected_region;
+}
+
+void clip_region_protect_ui(ClipRegion *out, const ClipRegion *region)
+{
+    *out = region ? *region : *clip_screen();
+    clip_region_exclude(out, UI_SEEDBANK_X, UI_SEEDBANK_Y, UI_SEEDBANK_WIDTH, UI_SEEDBANK_HEIGHT);
+    clip_region_exclude(out, UI_SUNBANK_X, UI_SUNBANK_Y, UI_SUNBANK_WIDTH, UI_SUNBANK_HEIGHT);
+}
+
+/**
+ * Remove [cut0, cut1) from a band's spans
+ */
+static void band_cut(ClipBand *band, int cut0, int cut1)
+{
+    int s;
+
+    // Spans added by a split start at cut1, so they are never cut again
+    for (s = 0; s < band->num_spans; s++) {
+        ClipSpan *sp = &band->spans[s];
+
+        if (cut1 <= sp->x0 || cut0 >= sp->x1) continue;
+
+        if (cut0 > sp->x0 && cut1 < sp->x1) {
+            // Cut in the middle: split in two (room is guaranteed:
+            // each exclusion adds at most one span)
+            band->spans[band->num_spans].x0 = cut1;
+            band->spans[band->num_spans].x1 = sp->x1;
+            band->num_spans++;
+            sp->x1 = cut0;
+        }
+        else if (cut0 <= sp->x0 && cut1 >= sp->x1) {
+            // Whole span removed
+            band->spans[s] = band->spans[--band->num_spans];
+            s--;
+        }
+        else if (cut0 <= sp->x0) {
+            sp->x0 = cut1;
+        }
+        else {
+            sp->x1 = cut0;
+        }
+    }
+}
+
+/**
+ * Keep spans in left-to-right order (at most CLIP_MAX_SPANS entries)
+ */
+static void band_sort(ClipBand *band)
+{
+    int i, j;
+
+    for (i = 1; i < band->num_spans; i++) {
+        ClipSpan key = band->spans[i];
+        for (j = i - 1; j >= 0 && band->spans[j].x0 > key.x0; j--)
+            band->spans[j + 1] = band->spans[j];
+        band->spans[j + 1] = key;
+    }
+}
+
+int clip_build_spans(const ClipRegion *region, int x, int y, int w, int h, ClipSpans *out)
+{
+    int ys[2 * CLIP_MAX_EXCLUDE + 2];
+    int num_ys = 0;
+    int x0, y0, x1, y1;
+    int i, j, e;
+
+    if (!region) region = clip_screen();
+
+    // Intersect with the bounds and the screen
+    x0 = x;
+    y0 = y;
+    x1 = x + w;
+    y1 = y + h;
+    if (x0 < region->bounds.x) x0 = region->bounds.x;
+    if (y0 < region->bounds.y) y0 = region->bounds.y;
+    if (x1 > region->bounds.x + region->bounds.w) x1 = region->bounds.x + region->bounds.w;
+    if (y1 > region->bounds.y + region->bounds.h) y1 = region->bounds.y + region->bounds.h;
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 > SCREEN_WIDTH) x1 = SCREEN_WIDTH;
+    if (y1 > SCREEN_HEIGHT) y1 = SCREEN_HEIGHT;
+
+    out->num_bands = 0;
+    out->x0 = x0;
+    out->y0 = y0;
+    out->x1 = x1;
+    out->y1 = y1;
+    if (x0 >= x1 || y0 >= y1) return 0;
+
+    // Band edges: the rect itself plus every exclusion edge inside it
+    ys[num_ys++] = y0;
+    ys[num_ys++] = y1;
+    for (e = 0; e < region->num_exclude; e++) {
+        const ClipRect *r = &region->exclude[e];
+        if (r->x >= x1 || r->x + r->w <= x0) continue;
+        if (r->y > y0 && r->y < y1) ys[num_ys++] = r->y;
+        if (r->y + r->h > y0 && r->y + r->h < y1) ys[num_ys++] = r->y + r->h;
+    }
+
+    // Sort and drop duplicates
+    for (i = 1; i < num_ys; i++) {
+        int key = ys[i];
+        for (j = i - 1; j >= 0 && ys[j] > key; j--)
+            ys[j + 1] = ys[j];
+        ys[j + 1] = key;
+    }
+
+    for (i = 0; i + 1 < num_ys; i++) {
+        ClipBand *band;
+
+        if (ys[i] == ys[i + 1]) continue;
+
+        band = &out->bands[out->num_bands];
+        band->y0 = ys[i];
+        band->y1 = ys[i + 1];
+        band->num_spans = 1;
+        band->spans[0].x0 = x0;
+        band->spans[0].x1 = x1;
+
+        for (e = 0; e < region->num_exclude; e++) {
+            const ClipRect *r = &region->exclude[e];
+            if (r->y <= band->y0 && r->y + r->h >= band->y1)
+                band_cut(band, r->x, r->x + r->w);
+        }
+
+        if (band->num_spans == 0) continue;
+
+        band_sort(band);
+        out->num_bands++;
+    }
+
+    return out->num_bands;
+}
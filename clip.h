@@ -0,0 +1,65 @@
+/* ------------------------------------------------------------ */
+/*              Clip Regions and Per-Row Draw Spans             */
+/* ------------------------------------------------------------ */
+#ifndef CLIP_H
+#define CLIP_H
+
+#include "xil_types.h"
+
+/* Exclusion rects per region (UI banks use 2) */
+#define CLIP_MAX_EXCLUDE     4
+
+/* Worst case: every exclusion splits a row once more */
+#define CLIP_MAX_SPANS       (CLIP_MAX_EXCLUDE + 1)
+#define CLIP_MAX_BANDS       (2 * CLIP_MAX_EXCLUDE + 1)
+
+typedef struct {
+    int x, y, w, h;
+} ClipRect;
+
+/* Where a draw may write: inside bounds, outside every exclusion */
+typedef struct {
+    ClipRect bounds;
+    int num_exclude;
+    ClipRect exclude[CLIP_MAX_EXCLUDE];
+} ClipRegion;
+
+/* Visible pixels [x0, x1) of a row */
+typedef struct {
+    int x0, x1;
+} ClipSpan;
+
+/* Rows [y0, y1) that share the same spans */
+typedef struct {
+    int y0, y1;
+    int num_spans;
+    ClipSpan spans[CLIP_MAX_SPANS];
+} ClipBand;
+
+/* Visible part of one draw, computed once per call */
+typedef struct {
+    int num_bands;
+    ClipBand bands[CLIP_MAX_BANDS];
+    int x0, y0, x1, y1;     // bounding box of the visible part
+} ClipSpans;
+
+/* Region setup */
+void clip_region_init(ClipRegion *region, int x, int y, int w, int h);
+void clip_region_exclude(ClipRegion *region, int x, int y, int w, int h);
+
+/* Shared regions: whole screen, and whole screen minus the UI banks */
+const ClipRegion *clip_screen(void);
+const ClipRegion *clip_ui_protected(void);
+
+/**
+ * Copy a region (NULL = screen) and add the UI banks as exclusions
+ */
+void clip_region_protect_ui(ClipRegion *out, const ClipRegion *region);
+
+/**
+ * Split the visible part of rect (x, y, w, h) into bands of per-row spans
+ * region NULL means the whole screen. Returns 0 if nothing is visible.
+ */
+int clip_build_spans(const ClipRegion *region, int x, int y, int w, int h, ClipSpans *out);
+
+#endif // CLIP_H
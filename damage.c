@@ -0,0 +1,725 @@
+/* ------------------------------------------------------------ */
+/*           Damage Tracking (Buffer-Age Rendering)             */
+/* ------------------------------------------------------------ */
+#include "damage.h"
+#include "pvz_game.h"
+#include "xil_cache.h"
+#include <string.h>
+
+#define FB_STRIDE  (SCREEN_WIDTH * 3)
+
+static DamageMode mode = DAMAGE_MODE_RECTS;
+
+// Damage of the last DAMAGE_HISTORY presented frames, indexed by seq % DAMAGE_HISTORY
+static DamageList history[DAMAGE_HISTORY];
+static TileMap tile_history[DAMAGE_HISTORY];
+
+// Damage recorded for the frame currently being rendered
+static DamageList current;
+static TileMap current_tiles;
+static int current_buffer = -1;
+
+// Set while draws are recorded by the caller instead (damage_pause)
+static u8 paused = 0;
+
+// Set when another core wrote part of the current frame (damage_mark_shared)
+static u8 shared = 0;
+
+// Tiles written to the current buffer this frame (sync copies + drawing)
+static TileMap written_tiles;
+
+// Rect mode: columns [x0, x1) written per row this frame (sync copies + drawing)
+static u16 written_x0[SCREEN_HEIGHT];
+static u16 written_x1[SCREEN_HEIGHT];
+static u8 written_full = 0;
+
+// Cache-line aligned range waiting to be flushed, merged with the next if adjacent
+static UINTPTR flush_start, flush_end;
+static u32 last_flush_bytes = 0;
+
+// Sequence number of the newest presented frame
+static u32 frame_seq = 0;
+
+// Sequence number of the frame each buffer holds (0 = unknown contents)
+static u32 buffer_seq[DAMAGE_MAX_BUFFERS];
+
+// Scratch used to build the union of several frames' damage
+static DamageList sync_list;
+static TileMap sync_tiles;
+static u32 last_sync_bytes = 0;
+
+/**
+ * Clear a damage list
+ */
+void damage_list_clear(DamageList *list)
+{
+    list->count = 0;
+    list->full = 0;
+}
+
+/**
+ * Mark the whole screen dirty
+ */
+void damage_list_add_full(DamageList *list)
+{
+    list->count = 0;
+    list->full = 1;
+}
+
+/**
+ * Add a rectangle to a damage list
+ * Rects already covered are dropped, rects the new one covers are removed.
+ * When the list is full the new rect is merged into the existing rect
+ * whose bounding box grows the least.
+ */
+void damage_list_add(DamageList *list, int x, int y, int w, int h)
+{
+    int i;
+    int best = 0, best_growth = 0;
+
+    if (list->full) return;
+
+    // Clip to screen
+    if (x < 0) { w += x; x = 0; }
+    if (y < 0) { h += y; y = 0; }
+    if (x + w > SCREEN_WIDTH) w = SCREEN_WIDTH - x;
+    if (y + h > SCREEN_HEIGHT) h = SCREEN_HEIGHT - y;
+    if (w <= 0 || h <= 0) return;
+
+    for (i = 0; i < list->count; i++) {
+        DamageRect *r = &list->rects[i];
+
+        // New rect already covered
+        if (x >= r->x && y >= r->y && x + w <= r->x + r->w && y + h <= r->y + r->h)
+            return;
+
+        // New rect covers an existing one - drop it
+        if (r->x >= x && r->y >= y && r->x + r->w <= x + w && r->y + r->h <= y + h) {
+            list->rects[i] = list->rects[--list->count];
+            i--;
+        }
+    }
+
+    if (list->count < DAMAGE_MAX_RECTS) {
+        list->rects[list->count].x = x;
+        list->rects[list->count].y = y;
+        list->rects[list->count].w = w;
+        list->rects[list->count].h = h;
+        list->count++;
+        return;
+    }
+
+    // List full: merge with the rect that grows the least
+    for (i = 0; i < list->count; i++) {
+        DamageRect *r = &list->rects[i];
+        int ux0 = (r->x < x) ? r->x : x;
+        int uy0 = (r->y < y) ? r->y : y;
+        int ux1 = (r->x + r->w > x + w) ? r->x + r->w : x + w;
+        int uy1 = (r->y + r->h > y + h) ? r->y + r->h : y + h;
+        int growth = (ux1 - ux0) * (uy1 - uy0) - r->w * r->h;
+
+        if (i == 0 || growth < best_growth) {
+            best = i;
+            best_growth = growth;
+        }
+    }
+
+    {
+        DamageRect *r = &list->rects[best];
+        int ux0 = (r->x < x) ? r->x : x;
+        int uy0 = (r->y < y) ? r->y : y;
+        int ux1 = (r->x + r->w > x + w) ? r->x + r->w : x + w;
+        int uy1 = (r->y + r->h > y + h) ? r->y + r->h : y + h;
+
+        r->x = ux0;
+        r->y = uy0;
+        r->w = ux1 - ux0;
+        r->h = uy1 - uy0;
+    }
+}
+
+/**
+ * Total pixel area of a damage list (overlaps counted twice)
+ */
+int damage_list_area(const DamageList *list)
+{
+    int i, area = 0;
+
+    if (list->full) return SCREEN_WIDTH * SCREEN_HEIGHT;
+
+    for (i = 0; i < list->count; i++)
+        area += list->rects[i].w * list->rects[i].h;
+
+    return area;
+}
+
+/**
+ * Clear a tile bitmap
+ */
+void tilemap_clear(TileMap *map)
+{
+    memset(map->rows, 0, sizeof(map->rows));
+}
+
+/**
+ * Mark every tile dirty
+ */
+void tilemap_mark_all(TileMap *map)
+{
+    int r;
+
+    for (r = 0; r < TILE_ROWS; r++)
+        map->rows[r] = (1u << TILE_COLS) - 1;
+}
+
+/**
+ * Column mask and row range of the tiles touched by a rectangle
+ * Returns 0 if the rectangle is off screen
+ */
+static int tilemap_rect_span(int x, int y, int w, int h, u32 *mask, int *r0, int *r1)
+{
+    int c0, c1;
+
+    if (x < 0) { w += x; x = 0; }
+    if (y < 0) { h += y; y = 0; }
+    if (x + w > SCREEN_WIDTH) w = SCREEN_WIDTH - x;
+    if (y + h > SCREEN_HEIGHT) h = SCREEN_HEIGHT - y;
+    if (w <= 0 || h <= 0) return 0;
+
+    c0 = x / TILE_W;
+    c1 = (x + w - 1) / TILE_W;
+    *r0 = y / TILE_H;
+    *r1 = (y + h - 1) / TILE_H;
+    *mask = ((1u << (c1 - c0 + 1)) - 1) << c0;
+    return 1;
+}
+
+/**
+ * Mark the tiles touched by a rectangle
+ */
+void tilemap_mark_rect(TileMap *map, int x, int y, int w, int h)
+{
+    u32 mask;
+    int r, r0, r1;
+
+    if (!tilemap_rect_span(x, y, w, h, &mask, &r0, &r1)) return;
+
+    for (r = r0; r <= r1; r++)
+        map->rows[r] |= mask;
+}
+
+/**
+ * dst |= src
+ */
+void tilemap_or(TileMap *dst, const TileMap *src)
+{
+    int r;
+
+    for (r = 0; r < TILE_ROWS; r++)
+        dst->rows[r] |= src->rows[r];
+}
+
+/**
+ * Returns 1 if any tile touched by the rectangle is dirty
+ */
+int tilemap_test_rect(const TileMap *map, int x, int y, int w, int h)
+{
+    u32 mask;
+    int r, r0, r1;
+
+    if (!tilemap_rect_span(x, y, w, h, &mask, &r0, &r1)) return 0;
+
+    for (r = r0; r <= r1; r++) {
+        if (map->rows[r] & mask) return 1;
+    }
+    return 0;
+}
+
+/**
+ * Returns 1 if every tile touched by the rectangle is dirty
+ */
+int tilemap_covers_rect(const TileMap *map, int x, int y, int w, int h)
+{
+    u32 mask;
+    int r, r0, r1;
+
+    if (!tilemap_rect_span(x, y, w, h, &mask, &r0, &r1)) return 1;
+
+    for (r = r0; r <= r1; r++) {
+        if ((map->rows[r] & mask) != mask) return 0;
+    }
+    return 1;
+}
+
+/**
+ * Number of dirty tiles
+ */
+int tilemap_count(const TileMap *map)
+{
+    int r, count = 0;
+
+    for (r = 0; r < TILE_ROWS; r++)
+        count += __builtin_popcount(map->rows[r]);
+
+    return count;
+}
+
+/**
+ * Find the next horizontal run of dirty tiles at or after (*row, *col)
+ * Usage:
+ *   int row = 0, col = 0, len;
+ *   while (tilemap_next_run(map, &row, &col, &len)) { ...; col += len; }
+ */
+int tilemap_next_run(const TileMap *map, int *row, int *col, int *len)
+{
+    int r = *row;
+    int c = *col;
+
+    for (; r < TILE_ROWS; r++, c = 0) {
+        u32 bits = (c < TILE_COLS) ? (map->rows[r] >> c) : 0;
+
+        if (bits) {
+            c += __builtin_ctz(bits);
+            *row = r;
+            *col = c;
+            *len = __builtin_ctz(~(map->rows[r] >> c));
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Copy a tile run (all TILE_H pixel rows) from src to dst
+ */
+static void copy_tile_run(u8 *dst, const u8 *src, int row, int col, int len)
+{
+    u32 offset = row * TILE_H * FB_STRIDE + col * TILE_W * 3;
+    int i;
+
+    for (i = 0; i < TILE_H; i++) {
+        memcpy(dst + offset, src + offset, len * TILE_W * 3);
+        offset += FB_STRIDE;
+    }
+}
+
+/**
+ * Forget which rows were written (rect mode)
+ */
+static void written_clear(void)
+{
+    int i;
+
+    written_full = 0;
+    for (i = 0; i < SCREEN_HEIGHT; i++) {
+        written_x0[i] = SCREEN_WIDTH;
+        written_x1[i] = 0;
+    }
+}
+
+/**
+ * Widen the written extent of every row the rect covers (rect mode)
+ */
+static void written_add(int x, int y, int w, int h)
+{
+    int i;
+
+    if (x < 0) { w += x; x = 0; }
+    if (y < 0) { h += y; y = 0; }
+    if (x + w > SCREEN_WIDTH) w = SCREEN_WIDTH - x;
+    if (y + h > SCREEN_HEIGHT) h = SCREEN_HEIGHT - y;
+    if (w <= 0 || h <= 0) return;
+
+    for (i = y; i < y + h; i++) {
+        if (x < written_x0[i]) written_x0[i] = x;
+        if (x + w > written_x1[i]) written_x1[i] = x + w;
+    }
+}
+
+/**
+ * Select rect or tile damage tracking
+ * Call damage_init afterwards - history from the other mode is not kept.
+ */
+void damage_set_mode(DamageMode new_mode)
+{
+    mode = new_mode;
+}
+
+DamageMode damage_get_mode(void)
+{
+    return mode;
+}
+
+/**
+ * Initialize damage history
+ * Call after all framebuffers have been filled with identical content.
+ */
+void damage_init(int num_buffers)
+{
+    int i;
+
+    frame_seq = 1;
+    for (i = 0; i < DAMAGE_MAX_BUFFERS; i++)
+        buffer_seq[i] = (i < num_buffers) ? frame_seq : 0;
+
+    for (i = 0; i < DAMAGE_HISTORY; i++) {
+        damage_list_clear(&history[i]);
+        tilemap_clear(&tile_history[i]);
+    }
+
+    damage_list_clear(&current);
+    tilemap_clear(&current_tiles);
+    tilemap_clear(&written_tiles);
+    written_clear();
+    current_buffer = -1;
+    last_sync_bytes = 0;
+    last_flush_bytes = 0;
+}
+
+/**
+ * Start recording damage for a frame rendered into buffer_index
+ */
+void damage_begin_frame(int buffer_index)
+{
+    current_buffer = buffer_index;
+    shared = 0;
+    damage_list_clear(&current);
+    tilemap_clear(&current_tiles);
+    tilemap_clear(&written_tiles);
+    if (mode == DAMAGE_MODE_RECTS)
+        written_clear();
+}
+
+/**
+ * Finish the current frame
+ * presented = 1: the frame was shown, its damage enters the history
+ * presented = 0: the frame was dropped; if anything was drawn the
+ *                buffer contents are no longer known
+ */
+void damage_end_frame(int presented)
+{
+    if (current_buffer < 0) return;
+
+    if (presented) {
+        frame_seq++;
+        history[frame_seq % DAMAGE_HISTORY] = current;
+        tile_history[frame_seq % DAMAGE_HISTORY] = current_tiles;
+        buffer_seq[current_buffer] = frame_seq;
+    }
+    else if (current.count || current.full || tilemap_count(&current_tiles)) {
+        buffer_seq[current_buffer] = 0;
+    }
+
+    current_buffer = -1;
+}
+
+/**
+ * Record a rectangle written in the current frame
+ * Called by every draw primitive; ignored outside begin/end.
+ */
+void damage_add(int x, int y, int w, int h)
+{
+    if (current_buffer < 0 || paused) return;
+
+    if (mode == DAMAGE_MODE_TILES) {
+        tilemap_mark_rect(&current_tiles, x, y, w, h);
+        tilemap_mark_rect(&written_tiles, x, y, w, h);
+    }
+    else {
+        damage_list_add(&current, x, y, w, h);
+        written_add(x, y, w, h);
+    }
+}
+
+/**
+ * Record that the whole current frame was rewritten
+ */
+void damage_add_full(void)
+{
+    if (current_buffer < 0 || paused) return;
+
+    if (mode == DAMAGE_MODE_TILES) {
+        tilemap_mark_all(&current_tiles);
+        tilemap_mark_all(&written_tiles);
+    }
+    else {
+        damage_list_add_full(&current);
+        written_full = 1;
+    }
+}
+
+/**
+ * Stop or resume recording draws into the current frame
+ */
+void damage_pause(int pause)
+{
+    paused = pause;
+}
+
+/**
+ * Note that another core wrote part of the current frame
+ */
+void damage_mark_shared(void)
+{
+    shared = 1;
+}
+
+/**
+ * Build the union of the damage of every frame presented since
+ * back_index was last rendered into sync_list or sync_tiles
+ * Returns 0 if the buffer already holds the newest frame.
+ */
+static int build_sync_union(int back_index)
+{
+    u32 age_seq = buffer_seq[back_index];
+    u32 s;
+    int i;
+
+    if (age_seq == frame_seq)
+        return 0;  // Already holds the newest frame
+
+    if (mode == DAMAGE_MODE_TILES) {
+        if (age_seq == 0 || frame_seq - age_seq > DAMAGE_HISTORY) {
+            tilemap_mark_all(&sync_tiles);
+        }
+        else {
+            tilemap_clear(&sync_tiles);
+            for (s = age_seq + 1; s <= frame_seq; s++)
+                tilemap_or(&sync_tiles, &tile_history[s % DAMAGE_HISTORY]);
+        }
+        return 1;
+    }
+
+    damage_list_clear(&sync_list);
+
+    if (age_seq == 0 || frame_seq - age_seq > DAMAGE_HISTORY) {
+        damage_list_add_full(&sync_list);
+    }
+    else {
+        for (s = age_seq + 1; s <= frame_seq && !sync_list.full; s++) {
+            const DamageList *past = &history[s % DAMAGE_HISTORY];
+
+            if (past->full) {
+                damage_list_add_full(&sync_list);
+                break;
+            }
+            for (i = 0; i < past->count; i++) {
+                damage_list_add(&sync_list, past->rects[i].x, past->rects[i].y,
+                                past->rects[i].w, past->rects[i].h);
+            }
+        }
+    }
+    return 1;
+}
+
+/**
+ * Bring a back buffer up to date with the front buffer
+ * Copies only the union of the damage of every frame presented since
+ * the back buffer was last rendered. Falls back to a full copy when the
+ * buffer is older than the history or its contents are unknown.
+ */
+void damage_sync_back_buffer(u8 *back, const u8 *front, int back_index)
+{
+    int i, row;
+
+    last_sync_bytes = 0;
+
+    if (!build_sync_union(back_index))
+        return;
+
+    if (mode == DAMAGE_MODE_TILES) {
+        int tile_row = 0, tile_col = 0, len;
+
+        while (tilemap_next_run(&sync_tiles, &tile_row, &tile_col, &len)) {
+            copy_tile_run(back, front, tile_row, tile_col, len);
+            last_sync_bytes += len * TILE_W * TILE_H * 3;
+            tile_col += len;
+        }
+
+        tilemap_or(&written_tiles, &sync_tiles);
+        buffer_seq[back_index] = frame_seq;
+        return;
+    }
+
+    if (sync_list.full) {
+        memcpy(back, front, FB_STRIDE * SCREEN_HEIGHT);
+        last_sync_bytes = FB_STRIDE * SCREEN_HEIGHT;
+        written_full = 1;
+    }
+    else {
+        for (i = 0; i < sync_list.count; i++) {
+            const DamageRect *r = &sync_list.rects[i];
+            u32 offset = r->y * FB_STRIDE + r->x * 3;
+
+            for (row = 0; row < r->h; row++) {
+                memcpy(back + offset, front + offset, r->w * 3);
+                offset += FB_STRIDE;
+            }
+            written_add(r->x, r->y, r->w, r->h);
+            last_sync_bytes += r->w * r->h * 3;
+        }
+    }
+
+    buffer_seq[back_index] = frame_seq;
+}
+
+/**
+ * Bring a back buffer up to date by redrawing instead of copying
+ * Hands the same regions damage_sync_back_buffer would copy to post(),
+ * so they are composed again along with this frame's damage. Never
+ * reads the front buffer - for framebuffers mapped uncached, where
+ * reads are slow but streaming writes are not.
+ * The regions count as written, like copied ones, but are not this
+ * frame's damage: the caller redraws them with recording paused, so
+ * each history entry holds only what its own frame changed.
+ */
+void damage_sync_redraw(int back_index, void (*post)(int x, int y, int w, int h))
+{
+    int i;
+
+    last_sync_bytes = 0;
+
+    if (!build_sync_union(back_index))
+        return;
+
+    if (mode == DAMAGE_MODE_TILES) {
+        int tile_row = 0, tile_col = 0, len;
+
+        while (tilemap_next_run(&sync_tiles, &tile_row, &tile_col, &len)) {
+            post(tile_col * TILE_W, tile_row * TILE_H, len * TILE_W, TILE_H);
+            tile_col += len;
+        }
+        tilemap_or(&written_tiles, &sync_tiles);
+    }
+    else if (sync_list.full) {
+        post(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+        written_full = 1;
+    }
+    else {
+        for (i = 0; i < sync_list.count; i++) {
+            const DamageRect *r = &sync_list.rects[i];
+            post(r->x, r->y, r->w, r->h);
+            written_add(r->x, r->y, r->w, r->h);
+        }
+    }
+
+    buffer_seq[back_index] = frame_seq;
+}
+
+/**
+ * Bytes copied by the last damage_sync_back_buffer call
+ */
+u32 damage_last_sync_bytes(void)
+{
+    return last_sync_bytes;
+}
+
+/**
+ * Flush the pending range, if any
+ */
+static void flush_commit(void)
+{
+    if (flush_end > flush_start) {
+        Xil_DCacheFlushRange(flush_start, flush_end - flush_start);
+        last_flush_bytes += flush_end - flush_start;
+    }
+    flush_start = flush_end = 0;
+}
+
+/**
+ * Queue [start, end) for flushing, widened to whole cache lines
+ * Ranges must come in increasing address order; a range touching the
+ * pending one is merged into it, otherwise the pending one is flushed.
+ */
+static void flush_add(UINTPTR start, UINTPTR end)
+{
+    start &= ~(UINTPTR)(DAMAGE_CACHE_LINE - 1);
+    end = (end + DAMAGE_CACHE_LINE - 1) & ~(UINTPTR)(DAMAGE_CACHE_LINE - 1);
+
+    if (flush_end > flush_start && start <= flush_end) {
+        if (end > flush_end) flush_end = end;
+        return;
+    }
+
+    flush_commit();
+    flush_start = start;
+    flush_end = end;
+}
+
+/**
+ * Flush the data cache for the parts of framebuf written this frame
+ * Written rows (rect mode) or tile runs (tile mode) are flushed as
+ * cache-line ranges, adjacent ranges merged. Above
+ * DAMAGE_FLUSH_FULL_BYTES the whole cache is flushed instead, unless
+ * another core wrote part of the frame: a flush by set/way only cleans
+ * this core's L1, while one by address is broadcast to both.
+ */
+void damage_flush_frame(const u8 *framebuf)
+{
+    UINTPTR base = (UINTPTR)framebuf;
+    u32 dirty = 0;
+    int row, i;
+
+    last_flush_bytes = 0;
+
+    if (mode == DAMAGE_MODE_TILES) {
+        dirty = tilemap_count(&written_tiles) * TILE_W * TILE_H * 3;
+    }
+    else if (written_full) {
+        dirty = FB_STRIDE * SCREEN_HEIGHT;
+    }
+    else {
+        for (row = 0; row < SCREEN_HEIGHT; row++) {
+            if (written_x1[row] > written_x0[row])
+                dirty += (written_x1[row] - written_x0[row]) * 3;
+        }
+    }
+
+    if (dirty == 0)
+        return;
+
+    if (dirty > DAMAGE_FLUSH_FULL_BYTES && !shared) {
+        Xil_DCacheFlush();
+        last_flush_bytes = FB_STRIDE * SCREEN_HEIGHT;
+        return;
+    }
+
+    if (mode == DAMAGE_MODE_TILES) {
+        for (row = 0; row < TILE_ROWS; row++) {
+            u32 bits = written_tiles.rows[row];
+
+            if (!bits) continue;
+
+            for (i = 0; i < TILE_H; i++) {
+                UINTPTR line = base + (row * TILE_H + i) * FB_STRIDE;
+                int col = 0, len;
+
+                while (col < TILE_COLS && (bits >> col)) {
+                    col += __builtin_ctz(bits >> col);
+                    len = __builtin_ctz(~(bits >> col));
+                    flush_add(line + col * TILE_W * 3, line + (col + len) * TILE_W * 3);
+                    col += len;
+                }
+            }
+        }
+    }
+    else {
+        for (row = 0; row < SCREEN_HEIGHT; row++) {
+            UINTPTR line = base + row * FB_STRIDE;
+
+            if (written_x1[row] > written_x0[row])
+                flush_add(line + written_x0[row] * 3, line + written_x1[row] * 3);
+        }
+    }
+
+    flush_commit();
+}
+
+/**
+ * Bytes flushed by the last damage_flush_frame call
+ * A whole-cache flush counts as one full frame.
+ */
+u32 damage_last_flush_bytes(void)
+{
+    return last_flush_bytes;
+}
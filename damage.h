@@ -0,0 +1,102 @@
+/* ------------------------------------------------------------ */
+/*           Damage Tracking (Buffer-Age Rendering)             */
+/* ------------------------------------------------------------ */
+#ifndef DAMAGE_H
+#define DAMAGE_H
+
+#include "xil_types.h"
+
+/* Maximum rectangles kept per frame before they get merged */
+#define DAMAGE_MAX_RECTS     64
+
+/* Number of past frames whose damage is remembered.
+ * A back buffer older than this is brought up to date with a full copy. */
+#define DAMAGE_HISTORY       4
+
+/* Maximum number of framebuffers tracked (DISPLAY_NUM_FRAMES <= this) */
+#define DAMAGE_MAX_BUFFERS   4
+
+/* L1/L2 data cache line size on the Cortex-A9 */
+#define DAMAGE_CACHE_LINE    32
+
+/* Dirty bytes above which one whole-cache flush beats flushing by range.
+ * Flushing by address costs one L1 and one L2 maintenance op per line,
+ * flushing by set/way is bounded by the cache size (512 KB L2). */
+#ifndef DAMAGE_FLUSH_FULL_BYTES
+#define DAMAGE_FLUSH_FULL_BYTES  (512 * 1024)
+#endif
+
+/* Tile renderer geometry: one u32 bitmask per tile row */
+#define TILE_W               32
+#define TILE_H               16
+#define TILE_COLS            (800 / TILE_W)     /* 25 */
+#define TILE_ROWS            (480 / TILE_H)     /* 30 */
+
+/* How damage is tracked, composed and flushed */
+typedef enum {
+    DAMAGE_MODE_RECTS = 0,      /* list of dirty rectangles */
+    DAMAGE_MODE_TILES = 1       /* bitmap of dirty TILE_W x TILE_H tiles */
+} DamageMode;
+
+/* Dirty rectangle (screen pixels, already clipped to the screen) */
+typedef struct {
+    int x, y, w, h;
+} DamageRect;
+
+/* Set of dirty rectangles for one frame */
+typedef struct {
+    int count;
+    u8 full;                            /* 1 = whole screen is dirty */
+    DamageRect rects[DAMAGE_MAX_RECTS];
+} DamageList;
+
+/* Dirty tile bitmap: bit c of rows[r] = tile (c, r) */
+typedef struct {
+    u32 rows[TILE_ROWS];
+} TileMap;
+
+/* Rectangle list helpers */
+void damage_list_clear(DamageList *list);
+void damage_list_add(DamageList *list, int x, int y, int w, int h);
+void damage_list_add_full(DamageList *list);
+int damage_list_area(const DamageList *list);
+
+/* Tile bitmap helpers */
+void tilemap_clear(TileMap *map);
+void tilemap_mark_all(TileMap *map);
+void tilemap_mark_rect(TileMap *map, int x, int y, int w, int h);
+void tilemap_or(TileMap *dst, const TileMap *src);
+int tilemap_test_rect(const TileMap *map, int x, int y, int w, int h);
+int tilemap_covers_rect(const TileMap *map, int x, int y, int w, int h);
+int tilemap_count(const TileMap *map);
+int tilemap_next_run(const TileMap *map, int *row, int *col, int *len);
+
+/* Buffer-age history */
+void damage_set_mode(DamageMode mode);
+DamageMode damage_get_mode(void);
+void damage_init(int num_buffers);
+void damage_begin_frame(int buffer_index);
+void damage_end_frame(int presented);
+void damage_add(int x, int y, int w, int h);
+void damage_add_full(void);
+
+/**
+ * Stop (1) or resume (0) recording draws into the current frame
+ * For draws the caller has already recorded, e.g. while both cores
+ * compose one frame: the record is not safe to update from two cores.
+ */
+void damage_pause(int pause);
+
+/**
+ * Note that another core wrote part of the current frame
+ * Its flush is then done by address, which reaches every core's L1;
+ * a whole-cache flush by set/way only cleans the caller's.
+ */
+void damage_mark_shared(void);
+void damage_sync_back_buffer(u8 *back, const u8 *front, int back_index);
+void damage_sync_redraw(int back_index, void (*post)(int x, int y, int w, int h));
+u32 damage_last_sync_bytes(void);
+void damage_flush_frame(const u8 *framebuf);
+u32 damage_last_flush_bytes(void);
+
+#endif // DAMAGE_H
@@ -10,6 +10,7 @@
 #define DEMO_MAX_FRAME          (800 * 480 * 3)    // = 2,764,800 ֽ
 #define DEMO_STRIDE             (800 * 3)           // = 3,840 ֽ
 
-#define DISPLAY_NUM_FRAMES      2
+// Must match display_ctrl.h, which main.c includes after this file
+#define DISPLAY_NUM_FRAMES      3
 
 #endif
@@ -0,0 +1,219 @@
+/* ------------------------------------------------------------ */
+/*              Display List (Retained Draw Commands)           */
+/* ------------------------------------------------------------ */
+#include "display_list.h"
+#include <stdio.h>
+#include <string.h>
+
+void displist_clear(DisplayList *list)
+{
+    list->count = 0;
+}
+
+void displist_add(DisplayList *list, int sprite, int frame, int x, int y, int w, int h,
+                  int layer, int clip, int id)
+{
+    DrawCmd *cmd;
+
+    if (list->count >= DL_MAX_CMDS) {
+        printf("WARNING: display list full, command dropped\n");
+        return;
+    }
+
+    cmd = &list->cmds[list->count++];
+    cmd->sprite = (u8)sprite;
+    cmd->frame = (u8)frame;
+    cmd->layer = (u8)layer;
+    cmd->clip = (u8)clip;
+    cmd->x = (s16)x;
+    cmd->y = (s16)y;
+    cmd->w = (s16)w;
+    cmd->h = (s16)h;
+    cmd->id = (u16)id;
+}
+
+/**
+ * Draw order: layer first, then bottom edge (lower on screen = in front)
+ * The remaining fields only break ties, which makes the order total:
+ * equal lists always sort the same, and only commands drawing the same
+ * thing compare 0. The sprite id is left out, so the diff sees no change
+ * when two entities trade places pixel for pixel.
+ */
+static int cmd_compare(const DrawCmd *a, const DrawCmd *b)
+{
+    if (a->layer != b->layer) return a->layer - b->layer;
+    if (a->y + a->h != b->y + b->h) return (a->y + a->h) - (b->y + b->h);
+    if (a->x != b->x) return a->x - b->x;
+    if (a->sprite != b->sprite) return a->sprite - b->sprite;
+    if (a->frame != b->frame) return a->frame - b->frame;
+    if (a->y != b->y) return a->y - b->y;
+    if (a->w != b->w) return a->w - b->w;
+    if (a->h != b->h) return a->h - b->h;
+    return a->clip - b->clip;
+}
+
+/**
+ * Sort into draw order
+ * Insertion sort: the list is built nearly in order (layers are
+ * emitted back to front), so it is close to linear.
+ */
+void displist_sort(DisplayList *list)
+{
+    int i, j;
+
+    for (i = 1; i < list->count; i++) {
+        DrawCmd cmd = list->cmds[i];
+
+        for (j = i; j > 0 && cmd_compare(&cmd, &list->cmds[j - 1]) < 0; j--)
+            list->cmds[j] = list->cmds[j - 1];
+        list->cmds[j] = cmd;
+    }
+}
+
+/**
+ * Clip region of each clip class for one damaged rectangle
+ */
+static void rect_clips(ClipRegion clips[2], int x, int y, int w, int h)
+{
+    clip_region_init(&clips[DL_CLIP_SCREEN], x, y, w, h);
+
+    clips[DL_CLIP_UNDER_UI] = clips[DL_CLIP_SCREEN];
+    clip_region_exclude(&clips[DL_CLIP_UNDER_UI], SUNBANK_X, SUNBANK_Y, SUNBANK_DRAW_WIDTH, SUNBANK_DRAW_HEIGHT);
+    clip_region_exclude(&clips[DL_CLIP_UNDER_UI], SEEDBANK_X, SEEDBANK_Y, SEEDBANK_DRAW_WIDTH, SEEDBANK_DRAW_HEIGHT);
+}
+
+/**
+ * Execute the commands overlapping one damaged rectangle, in list order
+ * Each clip class is built once per rectangle, not per command.
+ */
+void displist_draw_rect(const DisplayList *list, u8 *framebuf, int x, int y, int w, int h)
+{
+    ClipRegion clips[2];
+    int i;
+
+    rect_clips(clips, x, y, w, h);
+
+    for (i = 0; i < list->count; i++) {
+        const DrawCmd *cmd = &list->cmds[i];
+
+        if (cmd->x < x + w && x < cmd->x + cmd->w && cmd->y < y + h && y < cmd->y + cmd->h)
+            game_draw_command(framebuf, cmd, &clips[cmd->clip]);
+    }
+}
+
+/**
+ * Set bits come out lowest first, which is list order
+ */
+void displist_draw_marked(const DisplayList *list, const u32 *marked, u8 *framebuf,
+                          int x, int y, int w, int h)
+{
+    ClipRegion clips[2];
+    int word, i;
+    u32 bits;
+
+    rect_clips(clips, x, y, w, h);
+
+    for (word = 0; word < DL_MARK_WORDS; word++) {
+        for (bits = marked[word]; bits; bits &= bits - 1) {
+            const DrawCmd *cmd;
+
+            i = word * 32 + __builtin_ctz(bits);
+            if (i >= list->count)
+                return;
+            cmd = &list->cmds[i];
+            if (cmd->x < x + w && x < cmd->x + cmd->w && cmd->y < y + h && y < cmd->y + cmd->h)
+                game_draw_command(framebuf, cmd, &clips[cmd->clip]);
+        }
+    }
+}
+
+/**
+ * Post the bounds of every command that is in one sorted list but not
+ * the other
+ * Both lists are in cmd_compare order, so one merge pass pairs up the
+ * unchanged commands. Returns the number of bounds posted.
+ */
+int displist_diff(const DisplayList *prev, const DisplayList *curr,
+                  void (*post)(int x, int y, int w, int h))
+{
+    int i = 0, j = 0, posted = 0;
+
+    while (i < prev->count || j < curr->count) {
+        const DrawCmd *cmd;
+        int c;
+
+        if (i == prev->count)
+            c = 1;
+        else if (j == curr->count)
+            c = -1;
+        else
+            c = cmd_compare(&prev->cmds[i], &curr->cmds[j]);
+
+        if (c == 0) {
+            // Unchanged: still on screen as drawn
+            i++;
+            j++;
+            continue;
+        }
+
+        // Gone or changed: erase the old bounds; new or changed: draw the new ones
+        cmd = (c < 0) ? &prev->cmds[i++] : &curr->cmds[j++];
+        post(cmd->x, cmd->y, cmd->w, cmd->h);
+        posted++;
+    }
+
+    return posted;
+}
+
+/* ============================================================ */
+/*                     CAPTURE / REPLAY                         */
+/* ============================================================ */
+
+/**
+ * Print the list in the text format displist_parse_line reads back
+ */
+void displist_capture(const DisplayList *list)
+{
+    int i;
+
+    printf("DL begin %d\n", list->count);
+    for (i = 0; i < list->count; i++) {
+        const DrawCmd *c = &list->cmds[i];
+        printf("DL %d %d %d %d %d %d %d %d\n",
+               c->sprite, c->frame, c->x, c->y, c->w, c->h, c->layer, c->clip);
+    }
+    printf("DL end\n");
+}
+
+/**
+ * Parse one captured line into list
+ */
+int displist_parse_line(DisplayList *list, const char *line)
+{
+    int sprite, frame, x, y, w, h, layer, clip, count;
+
+    // Log lines may carry a prefix (timestamps, terminal noise)
+    line = strstr(line, "DL ");
+    if (!line)
+        return 0;
+
+    if (sscanf(line, "DL begin %d", &count) == 1) {
+        displist_clear(list);
+        return 0;
+    }
+
+    if (strncmp(line, "DL end", 6) == 0)
+        return 1;
+
+    if (sscanf(line, "DL %d %d %d %d %d %d %d %d",
+               &sprite, &frame, &x, &y, &w, &h, &layer, &clip) != 8)
+        return 0;
+
+    if (sprite < 0 || sprite >= DL_NUM_SPRITES || clip < DL_CLIP_SCREEN || clip > DL_CLIP_UNDER_UI) {
+        printf("WARNING: bad display list command skipped: %s", line);
+        return 0;
+    }
+
+    displist_add(list, sprite, frame, x, y, w, h, layer, clip, DL_NO_ID);
+    return 0;
+}
@@ -0,0 +1,128 @@
+/* ------------------------------------------------------------ */
+/*              Display List (Retained Draw Commands)           */
+/* ------------------------------------------------------------ */
+#ifndef DISPLAY_LIST_H
+#define DISPLAY_LIST_H
+
+#include "xil_types.h"
+#include "pvz_game.h"
+#include "clip.h"
+
+/* What a command draws */
+typedef enum {
+    DL_SPRITE_SUNFLOWER = 0,    /* frame = animation frame */
+    DL_SPRITE_PEASHOOTER,
+    DL_SPRITE_SUN,
+    DL_SPRITE_ZOMBIE_WALK,      /* frame = walk sheet frame */
+    DL_SPRITE_ZOMBIE_BITE,      /* frame = bite sheet frame */
+    DL_SPRITE_PEA,
+    DL_NUM_SPRITES
+} DlSprite;
+
+/* Draw order, back to front; within a layer lower sprites are drawn later */
+typedef enum {
+    DL_LAYER_PLANT = 0,
+    DL_LAYER_SUN,
+    DL_LAYER_ZOMBIE,
+    DL_LAYER_PEA
+} DlLayer;
+
+/* Where a command may draw, on top of the damage being composed */
+typedef enum {
+    DL_CLIP_SCREEN = 0,         /* anywhere on screen */
+    DL_CLIP_UNDER_UI            /* hidden under the sun bank and seed bank */
+} DlClip;
+
+/* Command drawing no game sprite (e.g. replayed from a capture) */
+#define DL_NO_ID     0xFFFF
+
+/* One draw command (14 bytes) */
+typedef struct {
+    u8 sprite;          /* DlSprite */
+    u8 frame;
+    u8 layer;           /* DlLayer */
+    u8 clip;            /* DlClip */
+    s16 x, y;           /* top-left of the drawn rectangle */
+    s16 w, h;           /* drawn size (may extend off screen) */
+    u16 id;             /* game sprite id (SPRITE_ID_*) or DL_NO_ID; not part of the order */
+} DrawCmd;
+
+/* Enough for a sprite per grid cell and per entity slot */
+#define DL_MAX_CMDS  NUM_SPRITE_IDS
+
+/* Words in a bitmap with one bit per command slot */
+#define DL_MARK_WORDS  ((DL_MAX_CMDS + 31) / 32)
+
+typedef struct {
+    int count;
+    DrawCmd cmds[DL_MAX_CMDS];
+} DisplayList;
+
+/* Building */
+void displist_clear(DisplayList *list);
+void displist_add(DisplayList *list, int sprite, int frame, int x, int y, int w, int h,
+                  int layer, int clip, int id);
+
+/**
+ * Sort into draw order: by layer, then by bottom edge
+ * Ties are broken on the other fields, so the order depends only on
+ * which commands are in the list, never on the order they were added.
+ */
+void displist_sort(DisplayList *list);
+
+/**
+ * Damage between two sorted lists: post the bounds of every command
+ * that is not in both (moved, re-framed, added or removed)
+ * Returns the number of rectangles posted.
+ */
+int displist_diff(const DisplayList *prev, const DisplayList *curr,
+                  void (*post)(int x, int y, int w, int h));
+
+/**
+ * Execute every command that overlaps the rectangle, clipped to it
+ * The rectangle must already hold the background. List must be sorted.
+ */
+void displist_draw_rect(const DisplayList *list, u8 *framebuf, int x, int y, int w, int h);
+
+/**
+ * Same, but only for the commands marked in the bitmap (bit i for
+ * cmds[i]): callers that know which commands can reach the rectangle
+ * skip testing the rest
+ */
+void displist_draw_marked(const DisplayList *list, const u32 *marked, u8 *framebuf,
+                          int x, int y, int w, int h);
+
+/* Implemented by the game (pvz_game.c), which owns the sprite data */
+
+/* Emit the commands for the current game state, sorted */
+void game_build_display_list(const GameState *game, DisplayList *list);
+
+/* List the last game_draw_damage composed */
+const DisplayList *game_display_list(void);
+
+/* Draw one command inside clip */
+void game_draw_command(u8 *framebuf, const DrawCmd *cmd, const ClipRegion *clip);
+
+/* Draw a whole list over the background (replay) */
+void game_draw_display_list(u8 *framebuf, const DisplayList *list);
+
+/* Presented frames between captures in PVZ_DISPLAY_LIST_CAPTURE builds */
+#ifndef DL_CAPTURE_INTERVAL
+#define DL_CAPTURE_INTERVAL  600
+#endif
+
+/**
+ * Capture: print the list as "DL ..." text lines (UART log format)
+ *   DL begin <count>
+ *   DL <sprite> <frame> <x> <y> <w> <h> <layer> <clip>   (count lines)
+ *   DL end
+ */
+void displist_capture(const DisplayList *list);
+
+/**
+ * Replay: feed captured lines one at a time; other lines are ignored
+ * Returns 1 when a "DL end" completes the list, 0 otherwise.
+ */
+int displist_parse_line(DisplayList *list, const char *line);
+
+#endif // DISPLAY_LIST_H
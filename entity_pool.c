@@ -0,0 +1,46 @@
+/* ------------------------------------------------------------ */
+/*           Entity Pools (Free List + Dense Live Set)          */
+/* ------------------------------------------------------------ */
+#include "entity_pool.h"
+
+/**
+ * Every slot free, in slot order (the first spawns get slots 0, 1, ...)
+ */
+void pool_init(u16 *count, u16 *live, u16 *where, int capacity)
+{
+    int i;
+
+    for (i = 0; i < capacity; i++) {
+        live[i] = i;
+        where[i] = i;
+    }
+    *count = 0;
+}
+
+/**
+ * Claim the first free slot; the most recently freed one is reused first
+ */
+int pool_alloc(u16 *count, const u16 *live, int capacity)
+{
+    // Free slots already sit right after the live ones
+    if (*count >= capacity)
+        return -1;
+
+    return live[(*count)++];
+}
+
+/**
+ * Swap the slot with the last live one and shrink the live set over it
+ */
+void pool_free(u16 *count, u16 *live, u16 *where, int slot)
+{
+    int pos = where[slot];
+    int last = *count - 1;
+    int moved = live[last];
+
+    live[pos] = moved;
+    where[moved] = pos;
+    live[last] = slot;
+    where[slot] = last;
+    (*count)--;
+}
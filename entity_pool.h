@@ -0,0 +1,42 @@
+/* ------------------------------------------------------------ */
+/*           Entity Pools (Free List + Dense Live Set)          */
+/* ------------------------------------------------------------ */
+#ifndef ENTITY_POOL_H
+#define ENTITY_POOL_H
+
+#include "xil_types.h"
+
+/*
+ * A pool hands out slot indices of a fixed-size entity array. live[]
+ * is a permutation of every slot: live[0..count) are the entities in
+ * use, live[count..capacity) the free list, and where[slot] is the
+ * slot's position in live[]. Spawning takes live[count]; despawning
+ * swaps the slot with the last live one, so both are O(1) and loops
+ * visit only live entities. Entities keep their slot for their whole
+ * life; only their position in live[] changes.
+ *
+ * A despawn moves the last live slot into the freed position, so a
+ * loop that despawns as it goes must walk live[] backwards.
+ *
+ * Pools hold no pointers and can be copied with the state they index.
+ */
+
+/* Pool for an array of cap entities (cap <= 65535) */
+#define ENTITY_POOL(cap)  struct { u16 count; u16 live[cap]; u16 where[cap]; }
+
+#define POOL_CAPACITY(p)  ((int)(sizeof((p)->live) / sizeof((p)->live[0])))
+
+/* Every slot free */
+#define POOL_INIT(p)        pool_init(&(p)->count, (p)->live, (p)->where, POOL_CAPACITY(p))
+
+/* Claim a free slot; -1 when the pool is full */
+#define POOL_ALLOC(p)       pool_alloc(&(p)->count, (p)->live, POOL_CAPACITY(p))
+
+/* Return a live slot to the free list */
+#define POOL_FREE(p, slot)  pool_free(&(p)->count, (p)->live, (p)->where, (slot))
+
+void pool_init(u16 *count, u16 *live, u16 *where, int capacity);
+int pool_alloc(u16 *count, const u16 *live, int capacity);
+void pool_free(u16 *count, u16 *live, u16 *where, int slot);
+
+#endif // ENTITY_POOL_H
@@ -0,0 +1,103 @@
+/* ------------------------------------------------------------ */
+/*             Framebuffer Memory Attributes (MMU)              */
+/* ------------------------------------------------------------ */
+#include "fb_memory.h"
+#include "damage.h"
+#include "pvz_game.h"
+#include "xil_mmu.h"
+#include "xpseudo_asm.h"
+#include <stdio.h>
+
+// Attribute the boot translation table gives DDR (translation_table.S)
+#ifndef NORM_WB_CACHE
+#define NORM_WB_CACHE  0x15DE6
+#endif
+
+static u8 *region_base = 0;
+static u32 region_bytes = 0;
+static FbMemMode current_mode = FB_MEM_CACHED;
+
+static const char *mode_names[FB_MEM_NUM_MODES] = { "cached", "wc" };
+
+/**
+ * Apply the mode's attribute to every section of the region
+ */
+static void apply_mode(FbMemMode mode)
+{
+    u32 attrib = (mode == FB_MEM_WRITE_COMBINE) ? NORM_NONCACHE : NORM_WB_CACHE;
+    u32 offset;
+
+    // Xil_SetTlbAttributes flushes the caches before and after the change
+    for (offset = 0; offset < region_bytes; offset += FB_MEM_SECTION)
+        Xil_SetTlbAttributes((INTPTR)(region_base + offset), attrib);
+}
+
+/**
+ * Register the framebuffer region and map it with the given mode
+ */
+void fbmem_init(u8 *base, u32 bytes, FbMemMode mode)
+{
+    if (((UINTPTR)base & (FB_MEM_SECTION - 1)) || (bytes & (FB_MEM_SECTION - 1))) {
+        printf("WARNING: framebuffers not section aligned (%p, %lu bytes) - staying cached\n",
+               (void *)base, (unsigned long)bytes);
+        region_base = 0;
+        region_bytes = 0;
+        current_mode = FB_MEM_CACHED;
+        return;
+    }
+
+    region_base = base;
+    region_bytes = bytes;
+    fbmem_set_mode(mode);
+}
+
+/**
+ * Remap the framebuffer region
+ */
+void fbmem_set_mode(FbMemMode mode)
+{
+    if (region_bytes == 0)
+        return;
+
+    apply_mode(mode);
+    current_mode = mode;
+    printf("INFO: Framebuffer memory: %s (%lu MB)\n",
+           mode_names[mode], (unsigned long)(region_bytes / FB_MEM_SECTION));
+}
+
+FbMemMode fbmem_get_mode(void)
+{
+    return current_mode;
+}
+
+const char *fbmem_mode_name(FbMemMode mode)
+{
+    return mode_names[mode];
+}
+
+/**
+ * Bring a back buffer up to date with the strategy that suits the mode
+ * Uncached reads stall on every load, so write-combine mode recomposes
+ * the stale regions instead of copying them from the front buffer.
+ */
+void fbmem_sync_back_buffer(u8 *back, const u8 *front, int back_index)
+{
+    if (current_mode == FB_MEM_WRITE_COMBINE)
+        damage_sync_redraw(back_index, game_post_stale);
+    else
+        damage_sync_back_buffer(back, front, back_index);
+}
+
+/**
+ * Make a rendered frame visible to the VDMA
+ */
+void fbmem_present(const u8 *framebuf)
+{
+    if (current_mode == FB_MEM_WRITE_COMBINE) {
+        // Nothing cached: just wait for buffered writes to reach DDR
+        dsb();
+        return;
+    }
+
+    damage_flush_frame(framebuf);
+}
@@ -0,0 +1,45 @@
+/* ------------------------------------------------------------ */
+/*             Framebuffer Memory Attributes (MMU)              */
+/* ------------------------------------------------------------ */
+#ifndef FB_MEMORY_H
+#define FB_MEMORY_H
+
+#include "xil_types.h"
+
+/* MMU section size: attributes are set per 1 MB section */
+#define FB_MEM_SECTION       0x100000
+
+/* Round a byte count up to whole sections */
+#define FB_MEM_SECTION_ROUND(bytes)  (((bytes) + FB_MEM_SECTION - 1) & ~(FB_MEM_SECTION - 1))
+
+typedef enum {
+    FB_MEM_CACHED = 0,          /* write-back cached, flushed before each present */
+    FB_MEM_WRITE_COMBINE = 1,   /* normal non-cacheable (bufferable), no flush */
+    FB_MEM_NUM_MODES
+} FbMemMode;
+
+/**
+ * Register the framebuffer region and map it with the given mode
+ * base and bytes must cover whole sections used by nothing else.
+ */
+void fbmem_init(u8 *base, u32 bytes, FbMemMode mode);
+
+/* Remap the region; the caches are flushed as part of the switch */
+void fbmem_set_mode(FbMemMode mode);
+FbMemMode fbmem_get_mode(void);
+const char *fbmem_mode_name(FbMemMode mode);
+
+/**
+ * Bring a back buffer up to date, using the strategy that suits the mode
+ * Cached: copy damaged regions from the front buffer.
+ * Write-combine: post them to be redrawn, so the framebuffer is never read.
+ */
+void fbmem_sync_back_buffer(u8 *back, const u8 *front, int back_index);
+
+/**
+ * Make a rendered frame visible to the VDMA
+ * Cached: flush the written ranges. Write-combine: drain the write buffer.
+ */
+void fbmem_present(const u8 *framebuf);
+
+#endif // FB_MEMORY_H
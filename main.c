@@ -14,6 +14,22 @@
 #include "pvz_game.h"
 #include "background1_hd.h"
 #include "touch_event_queue.h"
+#include "damage.h"
+#include "sprite_cache.h"
+#include "plant_tiles.h"
+#include "display_list.h"
+#include "blit_kernels.h"
+#include "present.h"
+#include "fb_memory.h"
+#include "xtime_l.h"
+#ifdef PVZ_DUAL_CORE
+#include "snapshot.h"
+#include "smp.h"
+#include "render_bands.h"
+#endif
+#ifdef PVZ_BENCHMARK
+#include "bench.h"
+#endif
 
 // Parameter definitions
 #define DYNCLK_BASEADDR XPAR_AXI_DYNCLK_0_BASEADDR
@@ -27,13 +43,22 @@ XIicPs I2C0_Inst;
 XScuGic GIC_Inst;
 XScuTimer Timer_Inst;
 
-// Frame buffers (must be 2 or 3)
-u8 frameBuf[DISPLAY_NUM_FRAMES][DEMO_MAX_FRAME];
+// Frame buffers (must be 2 or 3; 3 lets rendering run ahead of VSYNC)
+// Whole 1 MB MMU sections of their own, so fb_memory can remap them
+#define FRAME_REGION_BYTES  FB_MEM_SECTION_ROUND(DISPLAY_NUM_FRAMES * DEMO_MAX_FRAME)
+u8 frameBuf[FRAME_REGION_BYTES] __attribute__((aligned(FB_MEM_SECTION)));
 
 // Global tick counter (incremented by Timer ISR)
 volatile u32 g_tick = 0;
 
+// Global timer count at the latest tick (set by Timer ISR)
+volatile XTime g_tick_time = 0;
+
+// Global timer counts per simulation tick
+#define COUNTS_PER_TICK  (COUNTS_PER_SECOND / TIMER_FREQ_HZ)
+
 // VDMA frame done flag (set by VDMA ISR, cleared by main loop)
+// Wakes the main loop when it is waiting for a free buffer
 volatile int vdma_frame_done = 0;
 
 // Game state
@@ -90,7 +115,16 @@ static void VdmaReadIntrHandler(void *Callback, u32 Mask)
 
     /* Check for frame count interrupt (frame done) */
     if (Mask & XAXIVDMA_IXR_FRMCNT_MASK) {
+        /* Flip to the newest queued frame at the frame boundary;
+         * the buffer that was on screen goes back to the renderer */
+        int next = present_on_vsync();
+        if (next >= 0) {
+            DisplayChangeFrame(&DispCtrl_Inst, next);
+        }
         vdma_frame_done = 1;
+#ifdef PVZ_DUAL_CORE
+        smp_signal();  /* Wake the renderer on CPU1 */
+#endif
     }
 
     /* Check for errors */
@@ -102,32 +136,335 @@ static void VdmaReadIntrHandler(void *Callback, u32 Mask)
 }
 
 /* ============================================================ */
-/*    CRITICAL FIX: Proper VSYNC-synchronized frame present     */
+/*    Present queue: tear-free flips without blocking           */
 /* ============================================================ */
 
 /**
- * Present a frame at VSYNC boundary (TEAR-FREE)
+ * Get a buffer to render into
  *
- * CORRECT ORDER:
- * 1. Wait for current frame to finish scanning (VSYNC/FrameDone)
- * 2. Switch frame pointer at frame boundary
- *
- * WRONG ORDER (causes tearing):
- * 1. Switch frame pointer immediately (may be mid-scan!)
- * 2. Wait for new frame
+ * Frames are flipped by the VDMA interrupt at the frame boundary
+ * (no tearing), so the CPU only waits here when every buffer is on
+ * screen or queued - never with three buffers.
  */
-static inline void present_frame_at_vsync(int frame_index)
+static int acquire_render_buffer(void)
 {
-    /* STEP 1: Wait for current frame to finish scanning */
-    while (!vdma_frame_done) {
-        __asm__ volatile("wfi");  /* Save power while waiting */
+    int index;
+
+    while ((index = present_acquire()) < 0) {
+        while (!vdma_frame_done) {
+#ifdef PVZ_DUAL_CORE
+            smp_wait();  /* CPU1 takes no interrupts: the VSYNC handler sends an event */
+#else
+            __asm__ volatile("wfi");  /* Save power while waiting */
+#endif
+        }
+        vdma_frame_done = 0;
     }
-    vdma_frame_done = 0;  /* Clear flag */
 
-    /* STEP 2: Now it's safe - switch at frame boundary (no tearing!) */
-    DisplayChangeFrame(&DispCtrl_Inst, frame_index);
+    return index;
 }
 
+/* ============================================================ */
+/*    Main loop steps: simulation and rendering                 */
+/* ============================================================ */
+
+// Render state: newest completed frame (what the next frame is synced
+// from) and the play state the screen currently shows
+static int front_index = 0;
+static GamePlayState prev_play_state = GAME_PLAYING;
+static int fade_needs_black_transition = 0;
+
+#ifdef PVZ_DISPLAY_LIST_CAPTURE
+// Presented frames, for the periodic display list capture
+static u32 captured_presents = 0;
+#endif
+
+/**
+ * Simulation: run the fixed-timestep updates for the ticks counted by
+ * the timer interrupt, then apply touch input
+ * Never touches a framebuffer. Returns nonzero if the state changed.
+ */
+static int simulate_step(GameState *game)
+{
+    // Touch state machine and tick accumulator
+    static int has_down = 0;
+    static u16 down_x = 0, down_y = 0;
+    static u32 tick_accum = 0;
+
+    const u32 MAX_STEPS_PER_FRAME = 3;
+    u32 steps = 0;
+    int touched = 0;
+    XTime tick_time;
+    TouchEvent ev;
+
+    // ===== STEP 1: Atomically consume ticks =====
+    Xil_ExceptionDisable();
+    tick_accum += g_tick;
+    g_tick = 0;
+    tick_time = g_tick_time;
+    Xil_ExceptionEnable();
+
+    // ===== STEP 2: Fixed-timestep update =====
+    while (tick_accum && steps < MAX_STEPS_PER_FRAME) {
+        tick_accum--;
+        steps++;
+
+        // Positions before this tick: the renderer blends from here
+        game_begin_tick(game);
+
+        game_update_gameover(game);
+
+        if (game->play_state == GAME_PLAYING) {
+            game_update_animation(game);
+            game_check_pea_zombie_collision(game);
+        }
+
+        // What changed on screen is found by diffing display lists at render time
+        game_update_peas(game);
+        game_update_suns(game);
+        game_update_zombies(game);
+    }
+
+    // Caught up: the state is the one due at the latest tick. Behind
+    // (ticks left over): no blending, the newest state is late already.
+    if (steps)
+        game->tick_time = tick_accum ? 0 : tick_time;
+
+    // ===== STEP 3: Process touch events =====
+    while (tq_pop(&ev)) {
+        touched = 1;
+        if (ev.is_down) {
+            has_down = 1;
+            down_x = ev.x;
+            down_y = ev.y;
+        }
+        else {
+            if (has_down) {
+                // Collected suns and new plants show up in the display list diff;
+                // bank changes are redrawn into the clean plate
+                if (!game_check_sun_click(game, down_x, down_y)) {
+                    game_handle_touch(game, down_x, down_y);
+                }
+            }
+            has_down = 0;
+        }
+    }
+
+    return steps || touched;
+}
+
+#ifndef PVZ_NO_INTERPOLATION
+/**
+ * How far the clock is past view's tick, in ticks (0..1)
+ * Sprites are drawn that far between the previous and the newest
+ * tick, so motion stays smooth whatever the display and tick rates.
+ */
+static float interpolation_alpha(const GameState *view)
+{
+    XTime now;
+
+    if (view->tick_time == 0)
+        return 1.0f;
+
+    XTime_GetTime(&now);
+    if (now <= view->tick_time)
+        return 0.0f;
+    if (now - view->tick_time >= COUNTS_PER_TICK)
+        return 1.0f;
+    return (float)(now - view->tick_time) / (float)COUNTS_PER_TICK;
+}
+#endif
+
+/**
+ * Rendering: draw view into a free buffer and queue it for VSYNC
+ * view is only read (in dual-core mode it is a published snapshot).
+ */
+static void render_step(GameState *view)
+{
+    // ===== STEP 4: Render to back buffer =====
+    // Get a buffer that is neither on screen nor waiting to be shown
+    int next_render = acquire_render_buffer();
+    u8 *fb = (u8 *)DispCtrl_Inst.framePtr[next_render];
+    u8 *front = (u8 *)DispCtrl_Inst.framePtr[front_index];
+
+#ifdef PVZ_BENCHMARK
+    XTime t_render, t_present, t_done;
+    XTime_GetTime(&t_render);
+#endif
+
+    // Single flag: do we need to present this frame?
+    int need_present = 0;
+
+    // Record every rect drawn into fb from here on
+    damage_begin_frame(next_render);
+
+#ifndef PVZ_NO_INTERPOLATION
+    // Moving sprites where they are now, between the last two ticks
+    game_set_interpolation(interpolation_alpha(view));
+#endif
+
+    if (view->play_state == GAME_PLAYING) {
+        if (prev_play_state != GAME_PLAYING) {
+            set_pwm_duty(XPAR_AX_PWM_0_S00_AXI_BASEADDR, PWM_duty);
+
+            // Full redraw to clear defeat image
+            game_draw_full(view, fb);
+
+            need_present = 1;
+            prev_play_state = GAME_PLAYING;
+            fade_needs_black_transition = 0;
+        }
+        else if (game_damage_changes(view)) {
+            // Incremental: bring fb up to date with only the regions
+            // damaged since fb was last rendered (copied or redrawn)
+            fbmem_sync_back_buffer(fb, front, next_render);
+
+            // One composition pass over all damaged regions
+            game_draw_damage(view, fb);
+
+            need_present = 1;
+        }
+    }
+    else if (view->play_state == GAME_FADING_TO_BLACK) {
+        if (prev_play_state != GAME_FADING_TO_BLACK) {
+            game_draw_full(view, fb);
+
+            prev_play_state = GAME_FADING_TO_BLACK;
+            fade_needs_black_transition = 1;
+            need_present = 1;
+        }
+        else if (game_damage_changes(view)) {
+            // Sync from current display, redraw what the zombies changed
+            fbmem_sync_back_buffer(fb, front, next_render);
+            game_draw_damage(view, fb);
+            need_present = 1;
+        }
+
+        // PWM fade (runs every frame during fade state)
+        float duty = PWM_duty + (1.0f - PWM_duty) * view->fade_progress;
+        if (duty > 1.0f) duty = 1.0f;
+        set_pwm_duty(XPAR_AX_PWM_0_S00_AXI_BASEADDR, duty);
+
+        // Transition to black screen when fade completes
+        if (view->fade_progress >= 0.99f && fade_needs_black_transition) {
+            // This will be shown in the NEXT frame after zombies
+            fade_needs_black_transition = 0;
+            // Don't render black here - let it happen in next loop iteration
+            // when state transitions to GAME_SHOWING_DEFEAT
+        }
+    }
+    else if (view->play_state == GAME_SHOWING_DEFEAT) {
+        if (prev_play_state != GAME_SHOWING_DEFEAT) {
+            set_pwm_duty(XPAR_AX_PWM_0_S00_AXI_BASEADDR, PWM_duty);
+
+            // Frame statistics for the round
+            present_report();
+
+            // Fill black first
+            game_fill_black(fb);
+            prev_play_state = GAME_SHOWING_DEFEAT;
+            need_present = 1;
+        }
+        else {
+            // Animate defeat image scaling
+            // Sync current (black), then draw defeat
+            damage_sync_back_buffer(fb, front, next_render);
+            game_draw_defeat_image(fb, view->defeat_scale);
+            need_present = 1;
+        }
+    }
+    else if (view->play_state == GAME_RESTARTING) {
+        if (prev_play_state != GAME_RESTARTING) {
+            prev_play_state = GAME_RESTARTING;
+
+            game_fill_black(fb);
+            game_draw_defeat_image(fb, 1.0f);
+            need_present = 1;
+        }
+    }
+
+    // Commit this frame's damage to the history (or drop it)
+    damage_end_frame(need_present);
+
+    // ===== STEP 5: Queue for the next VSYNC (ONLY ONCE PER LOOP) =====
+    if (need_present) {
+#ifdef PVZ_BENCHMARK
+        XTime_GetTime(&t_present);
+#endif
+
+        /* Flush cache (or drain write buffer) for what we just rendered */
+        fbmem_present(fb);
+
+        /* The VDMA interrupt flips to it at the next frame boundary;
+         * rendering carries on into a free buffer meanwhile */
+        present_queue(next_render);
+        front_index = next_render;
+
+#ifdef PVZ_DISPLAY_LIST_CAPTURE
+        // Dump the frame's draw commands for tools/dl_replay
+        if (view->play_state == GAME_PLAYING && ++captured_presents % DL_CAPTURE_INTERVAL == 0)
+            displist_capture(game_display_list());
+#endif
+
+#ifdef PVZ_BENCHMARK
+        XTime_GetTime(&t_done);
+        bench_fb_memory_frame(t_present - t_render, t_done - t_present);
+#endif
+    } else {
+        present_release(next_render);
+    }
+}
+
+#ifdef PVZ_DUAL_CORE
+// Game states handed from the simulation (CPU0) to the renderer (CPU1)
+static SnapshotBuffer snapshots;
+
+// Set by CPU0 once start-up is done and CPU1 takes over rendering
+static volatile u32 render_handover = 0;
+
+/**
+ * CPU1: help compose CPU0's start-up frames in bands, then render one
+ * frame per VSYNC from the newest snapshot, like the single-core loop.
+ * Snapshots come in at the tick rate, faster than the display, so
+ * rendering on every one would compose frames that are replaced before
+ * they are shown. Without interpolation a frame is only drawn when a
+ * new snapshot has come in since the last one.
+ */
+static void render_core_main(void)
+{
+    GameState *view = NULL, *next;
+    int fresh = 0;
+
+    while (!render_handover) {
+        if (!bands_help())
+            smp_wait();
+    }
+    __asm__ volatile("dmb sy" ::: "memory");
+
+    while (1) {
+        next = snapshot_acquire(&snapshots);
+        if (next) {
+            view = next;
+            fresh = 1;
+        }
+
+#ifndef PVZ_NO_INTERPOLATION
+        // Interpolated sprites move at every VSYNC, new tick or not
+        fresh = (view != NULL);
+#endif
+        if (fresh && vdma_frame_done) {
+            vdma_frame_done = 0;
+            fresh = 0;
+            render_step(view);
+        }
+
+        // The VSYNC handler and each publish send an event, so one that
+        // came in since the checks above ends the wait at once
+        smp_wait();
+    }
+}
+#endif
+
 /* ============================================================ */
 
 // Function declarations
@@ -157,7 +494,7 @@ int main(void)
 
     // Initialize frame buffer pointers
     for (i = 0; i < DISPLAY_NUM_FRAMES; i++)
-        pFrames[i] = frameBuf[i];
+        pFrames[i] = frameBuf + i * DEMO_MAX_FRAME;
 
     // Set PWM for LCD backlight
     PWM_duty = 0.7;
@@ -202,244 +539,111 @@ int main(void)
     // Initialize game
     game_init(&game);
 
-    // CRITICAL: Maintain explicit front/back buffer indices
-    int current_displayed = 0;  // Frame currently being scanned out
-    int next_render = 1;        // Frame we'll render to next
+    // Select NEON or scalar pixel kernels
+    kern_init();
+
+    // Pre-scale plant and zombie frames to their display sizes
+#ifdef PVZ_SPRITE_CACHE_LAZY
+    sprite_cache_init(SPRITE_CACHE_LAZY);
+#else
+    sprite_cache_init(SPRITE_CACHE_EAGER);
+#endif
+    sprite_cache_report();
+
+    // Cache planted cells as prebaked background + plant frame tiles
+#ifdef PVZ_NO_PLANT_TILES
+    plant_tile_init(0);
+#else
+    plant_tile_init(1);
+#endif
+
+#ifdef PVZ_TILE_RENDERER
+    // Track damage as a dirty-tile bitmap instead of a rect list
+    damage_set_mode(DAMAGE_MODE_TILES);
+#endif
+
+#ifdef PVZ_BENCHMARK
+    bench_sprite_formats((u8 *)DispCtrl_Inst.framePtr[0]);
+    bench_render_modes(&game, DispCtrl_Inst.framePtr, DISPLAY_NUM_FRAMES);
+    bench_anim_stagger(&game, DispCtrl_Inst.framePtr, DISPLAY_NUM_FRAMES);
+#endif
+
+    // Map the framebuffers cached (flush per present) or write-combined
+#ifdef PVZ_FB_WRITE_COMBINE
+    fbmem_init(frameBuf, FRAME_REGION_BYTES, FB_MEM_WRITE_COMBINE);
+#else
+    fbmem_init(frameBuf, FRAME_REGION_BYTES, FB_MEM_CACHED);
+#endif
+
+#ifdef PVZ_DUAL_CORE
+    // CPU1 composes half of every frame from here on
+    if (smp_start_cpu1(render_core_main) != 0) {
+        printf("ERROR: CPU1 did not start\n");
+        return XST_FAILURE;
+    }
+    bands_init(1);
+
+#ifdef PVZ_BENCHMARK
+    bench_band_render(&game, DispCtrl_Inst.framePtr, DISPLAY_NUM_FRAMES);
+#endif
+#endif
 
     // Initialize ALL buffers with same content
     printf("Initializing frame buffers...\n");
     for (i = 0; i < DISPLAY_NUM_FRAMES; i++) {
         u8 *init_fb = (u8 *)DispCtrl_Inst.framePtr[i];
-        memcpy(init_fb, gImage_background1_hd, DEMO_MAX_FRAME);
         game_draw_full(&game, init_fb);
         Xil_DCacheFlushRange((UINTPTR)init_fb, DEMO_MAX_FRAME);
     }
 
+    // All buffers now hold the same frame - start damage history from here
+    damage_init(DISPLAY_NUM_FRAMES);
+
     // Start displaying first buffer
-    DisplayChangeFrame(&DispCtrl_Inst, current_displayed);
+    present_init(DISPLAY_NUM_FRAMES, front_index);
+    DisplayChangeFrame(&DispCtrl_Inst, front_index);
     vdma_frame_done = 0;  // Clear flag
 
     printf("\n========================================\n");
     printf("Game started - TEAR-FREE rendering!\n");
     printf("========================================\n\n");
 
-    // Touch state machine
-    int has_down = 0;
-    u16 down_x = 0, down_y = 0;
-
-    // Tick accumulator
-    u32 tick_accum = 0;
-
-    // Game over rendering state
-    static int fade_needs_black_transition = 0;
-    static GamePlayState prev_play_state = GAME_PLAYING;
+    // Run: simulate and render on one core, or one core each
+#ifdef PVZ_DUAL_CORE
+    snapshot_init(&snapshots, &game);
+    __asm__ volatile("dmb sy" ::: "memory");
+    render_handover = 1;
+    smp_signal();
 
-    // Main loop
+    // CPU0: fixed-timestep simulation, publishing each new state; helps
+    // CPU1 compose the frame's bands when it has nothing else to do
+    while (1) {
+        if (simulate_step(&game)) {
+            snapshot_publish(&snapshots, &game);
+            smp_signal();
+        } else if (!bands_help()) {
+            smp_wait();  // Until the next tick, touch or band job
+        }
+    }
+#else
+    // Main loop: one frame per VSYNC. Three buffers mean render_step
+    // never waits for one, so sleep until the frame-done interrupt; the
+    // timer and touch interrupts wake the core to simulate meanwhile.
     while (1) {
-        // ===== STEP 1: Atomically consume ticks =====
+        // Masked, so a VSYNC landing after the check still ends the wfi
         Xil_ExceptionDisable();
-        tick_accum += g_tick;
-        g_tick = 0;
+        if (!vdma_frame_done)
+            __asm__ volatile("wfi");
         Xil_ExceptionEnable();
 
-        // Redraw flags
-        u32 flags = 0;
-        #define F_FULL   (1u << 0)
-        #define F_ANIM   (1u << 1)
-        #define F_SUN    (1u << 2)
-        #define F_ZOMBIE (1u << 3)
-        #define F_PEA    (1u << 4)
-
-        // ===== STEP 2: Fixed-timestep update =====
-        const u32 MAX_STEPS_PER_FRAME = 3;
-        u32 steps = 0;
-
-        while (tick_accum && steps < MAX_STEPS_PER_FRAME) {
-            tick_accum--;
-            steps++;
-
-            game_update_gameover(&game);
-
-            if (game.play_state == GAME_PLAYING) {
-                int prev_anim_changed = (game.animation_counter % FRAMES_PER_UPDATE == 0);
-                if (game_update_animation(&game)) {
-                    flags |= F_ANIM;
-                }
-                int now_anim_changed = (game.animation_counter % FRAMES_PER_UPDATE == 0);
-                if (prev_anim_changed || now_anim_changed) {
-                    flags |= F_ANIM;
-                }
-
-                game_check_pea_zombie_collision(&game);
-            }
-
-            int prev_peas = game.num_active_peas;
-            game_update_peas(&game);
-            if (game.num_active_peas || prev_peas) {
-                flags |= F_PEA;
-            }
-
-            int prev_suns = game.num_active_suns;
-            game_update_suns(&game);
-            if (game.num_active_suns || prev_suns) {
-                flags |= F_SUN;
-            }
+        simulate_step(&game);
 
-            int prev_zombies = game.num_active_zombies;
-            game_update_zombies(&game);
-            if (game.num_active_zombies || prev_zombies) {
-                flags |= F_ZOMBIE;
-            }
-        }
-
-        // ===== STEP 3: Process touch events =====
-        TouchEvent ev;
-        while (tq_pop(&ev)) {
-            if (ev.is_down) {
-                has_down = 1;
-                down_x = ev.x;
-                down_y = ev.y;
-            }
-            else {
-                if (has_down) {
-                    int prev_sun = game.sun_count;
-                    int prev_card = game.selected_card;
-
-                    int sun_clicked = game_check_sun_click(&game, down_x, down_y);
-
-                    if (sun_clicked) {
-                        flags |= F_FULL;
-                    }
-                    else {
-                        game_handle_touch(&game, down_x, down_y);
-
-                        if (game.sun_count != prev_sun || game.selected_card != prev_card) {
-                            flags |= F_FULL;
-                        }
-                    }
-                }
-                has_down = 0;
-            }
-        }
-
-        // ===== STEP 4: Render to back buffer =====
-        // Get pointer to the buffer we'll render to (NOT currently displayed)
-        u8 *fb = (u8 *)DispCtrl_Inst.framePtr[next_render];
-
-        // Single flag: do we need to present this frame?
-        int need_present = 0;
-
-        if (game.play_state == GAME_PLAYING) {
-            if (prev_play_state != GAME_PLAYING) {
-                set_pwm_duty(XPAR_AX_PWM_0_S00_AXI_BASEADDR, PWM_duty);
-
-                // Full redraw to clear defeat image
-                memcpy(fb, gImage_background1_hd, DEMO_MAX_FRAME);
-                game_draw_full(&game, fb);
-                game_draw_suns(&game, fb);
-                game_draw_peas(&game, fb);
-                game_draw_zombies(&game, fb);
-
-                need_present = 1;
-                prev_play_state = GAME_PLAYING;
-                fade_needs_black_transition = 0;
-            }
-            else if (flags & F_FULL) {
-                memcpy(fb, gImage_background1_hd, DEMO_MAX_FRAME);
-                game_draw_full(&game, fb);
-                game_draw_suns(&game, fb);
-                game_draw_peas(&game, fb);
-                game_draw_zombies(&game, fb);
-
-                need_present = 1;
-            }
-            else if (flags) {
-                // Incremental: copy from currently displayed buffer
-                memcpy(fb, (u8 *)DispCtrl_Inst.framePtr[current_displayed], DEMO_MAX_FRAME);
-
-                if (flags & F_ANIM)   game_draw_animation(&game, fb);
-                if (flags & F_SUN)    game_draw_suns(&game, fb);
-                if (flags & F_PEA)    game_draw_peas(&game, fb);
-                if (flags & F_ZOMBIE) game_draw_zombies(&game, fb);
-
-                need_present = 1;
-            }
-        }
-        else if (game.play_state == GAME_FADING_TO_BLACK) {
-            if (prev_play_state != GAME_FADING_TO_BLACK) {
-                memcpy(fb, gImage_background1_hd, DEMO_MAX_FRAME);
-                game_draw_full(&game, fb);
-                game_draw_suns(&game, fb);
-                game_draw_peas(&game, fb);
-                game_draw_zombies(&game, fb);
-
-                prev_play_state = GAME_FADING_TO_BLACK;
-                fade_needs_black_transition = 1;
-                need_present = 1;
-            }
-            else if (flags & F_ZOMBIE) {
-                // Copy from current display, update zombies
-                memcpy(fb, (u8 *)DispCtrl_Inst.framePtr[current_displayed], DEMO_MAX_FRAME);
-                game_draw_zombies(&game, fb);
-                need_present = 1;
-            }
-
-            // PWM fade (runs every frame during fade state)
-            float duty = PWM_duty + (1.0f - PWM_duty) * game.fade_progress;
-            if (duty > 1.0f) duty = 1.0f;
-            set_pwm_duty(XPAR_AX_PWM_0_S00_AXI_BASEADDR, duty);
-
-            // Transition to black screen when fade completes
-            if (game.fade_progress >= 0.99f && fade_needs_black_transition) {
-                // This will be shown in the NEXT frame after zombies
-                fade_needs_black_transition = 0;
-                // Don't render black here - let it happen in next loop iteration
-                // when state transitions to GAME_SHOWING_DEFEAT
-            }
-        }
-        else if (game.play_state == GAME_SHOWING_DEFEAT) {
-            if (prev_play_state != GAME_SHOWING_DEFEAT) {
-                set_pwm_duty(XPAR_AX_PWM_0_S00_AXI_BASEADDR, PWM_duty);
-
-                // Fill black first
-                game_fill_black(fb);
-                prev_play_state = GAME_SHOWING_DEFEAT;
-                need_present = 1;
-            }
-            else {
-                // Animate defeat image scaling
-                // Copy current (black), then draw defeat
-                memcpy(fb, (u8 *)DispCtrl_Inst.framePtr[current_displayed], DEMO_MAX_FRAME);
-                game_draw_defeat_image(fb, game.defeat_scale);
-                need_present = 1;
-            }
-        }
-        else if (game.play_state == GAME_RESTARTING) {
-            if (prev_play_state != GAME_RESTARTING) {
-                prev_play_state = GAME_RESTARTING;
-
-                game_fill_black(fb);
-                game_draw_defeat_image(fb, 1.0f);
-                need_present = 1;
-            }
-        }
-
-        // ===== STEP 5: VSYNC-synchronized present (ONLY ONCE PER LOOP) =====
-        if (need_present) {
-            /* Flush cache for the buffer we just rendered */
-            Xil_DCacheFlushRange((UINTPTR)fb, DEMO_MAX_FRAME);
-
-            /* CRITICAL FIX: Proper order for tear-free display
-             * 1. Wait for current frame to finish scanning
-             * 2. Switch to new frame at frame boundary
-             */
-            present_frame_at_vsync(next_render);
-
-            /* Update indices for next iteration */
-            current_displayed = next_render;
-            next_render = (next_render + 1) % DISPLAY_NUM_FRAMES;
+        if (vdma_frame_done) {
+            vdma_frame_done = 0;
+            render_step(&game);
         }
     }
+#endif
 
     return 0;
 }
@@ -533,6 +737,10 @@ int PS_timer_init(XScuTimer *Timer, u16 DeviceId, u32 timer_load)
 static void Timer_IRQ_Handler(void *CallBackRef)
 {
     XScuTimer *TimerInstancePtr = (XScuTimer *)CallBackRef;
+    XTime now;
+
     XScuTimer_ClearInterruptStatus(TimerInstancePtr);
+    XTime_GetTime(&now);
+    g_tick_time = now;
     g_tick++;
 }
@@ -0,0 +1,201 @@
+/* ------------------------------------------------------------ */
+/*                Prebaked Plant Cell Tile Cache                */
+/* ------------------------------------------------------------ */
+#include "plant_tiles.h"
+#include <stdio.h>
+#include <string.h>
+
+// Tile pixels; the slot count is fixed by PLANT_TILE_BUDGET_BYTES
+static u8 tile_pixels[PLANT_TILE_SLOTS][PLANT_TILE_BYTES];
+
+// Key held by each slot (cell < 0 = free) and when it was last used
+static struct {
+    s16 cell;
+    u8 type;
+    u8 frame;
+    u32 last_used;
+} slots[PLANT_TILE_SLOTS];
+
+// Slot holding each key, -1 = not cached
+static s16 slot_of[PLANT_TILE_CELLS][PLANT_TILE_TYPES][ANIMATION_FRAMES];
+
+static u32 use_clock = 0;
+static int enabled = 0;
+static PlantTileStats stats;
+
+static int key_valid(int cell, int type, int frame)
+{
+    return cell >= 0 && cell < PLANT_TILE_CELLS &&
+           type > PLANT_NONE && type < PLANT_TILE_TYPES &&
+           frame >= 0 && frame < ANIMATION_FRAMES;
+}
+
+static void free_slot(int s)
+{
+    if (slots[s].cell >= 0)
+        slot_of[slots[s].cell][slots[s].type][slots[s].frame] = -1;
+    slots[s].cell = -1;
+}
+
+/**
+ * Drop every tile (keeps the statistics)
+ */
+void plant_tile_invalidate_all(void)
+{
+    int s;
+
+    memset(slot_of, 0xFF, sizeof(slot_of));
+    for (s = 0; s < PLANT_TILE_SLOTS; s++)
+        slots[s].cell = -1;
+}
+
+/**
+ * Empty the cache and enable or disable it
+ */
+void plant_tile_init(int enable)
+{
+    plant_tile_invalidate_all();
+    memset(&stats, 0, sizeof(stats));
+    use_clock = 0;
+    enabled = enable;
+
+    printf("INFO: Plant tile cache %s: %d slots x %d bytes (%d byte budget)\n",
+           enable ? "on" : "off", PLANT_TILE_SLOTS, PLANT_TILE_BYTES, PLANT_TILE_BUDGET_BYTES);
+}
+
+void plant_tile_set_enabled(int enable)
+{
+    if (!enable)
+        plant_tile_invalidate_all();
+    enabled = enable;
+}
+
+int plant_tile_enabled(void)
+{
+    return enabled;
+}
+
+/**
+ * Find a cached tile and mark it most recently used
+ */
+const u8 *plant_tile_lookup(int cell, int type, int frame)
+{
+    int s;
+
+    if (!enabled || !key_valid(cell, type, frame))
+        return NULL;
+
+    s = slot_of[cell][type][frame];
+    if (s < 0) {
+        stats.misses++;
+        return NULL;
+    }
+
+    slots[s].last_used = ++use_clock;
+    stats.hits++;
+    return tile_pixels[s];
+}
+
+/**
+ * Find a tile, read only
+ */
+const u8 *plant_tile_peek(int cell, int type, int frame)
+{
+    int s;
+
+    if (!enabled || !key_valid(cell, type, frame))
+        return NULL;
+
+    s = slot_of[cell][type][frame];
+    return (s < 0) ? NULL : tile_pixels[s];
+}
+
+/**
+ * Reserve a slot: a free one if there is one, else the least recently used
+ * The scan is linear, but it only runs on a miss.
+ */
+u8 *plant_tile_alloc(int cell, int type, int frame)
+{
+    int s, victim = 0;
+
+    if (!enabled || !key_valid(cell, type, frame))
+        return NULL;
+
+    // Re-baking an existing key reuses its slot
+    s = slot_of[cell][type][frame];
+    if (s >= 0) {
+        slots[s].last_used = ++use_clock;
+        return tile_pixels[s];
+    }
+
+    for (s = 0; s < PLANT_TILE_SLOTS; s++) {
+        if (slots[s].cell < 0) {
+            victim = s;
+            break;
+        }
+        if (slots[s].last_used < slots[victim].last_used)
+            victim = s;
+    }
+
+    if (s == PLANT_TILE_SLOTS) {
+        stats.evictions++;
+        free_slot(victim);
+    }
+
+    slots[victim].cell = (s16)cell;
+    slots[victim].type = (u8)type;
+    slots[victim].frame = (u8)frame;
+    slots[victim].last_used = ++use_clock;
+    slot_of[cell][type][frame] = (s16)victim;
+
+    return tile_pixels[victim];
+}
+
+/**
+ * Drop every tile whose cell overlaps the rectangle
+ */
+void plant_tile_invalidate_rect(int x, int y, int w, int h)
+{
+    int s;
+
+    for (s = 0; s < PLANT_TILE_SLOTS; s++) {
+        int cell_x, cell_y;
+
+        if (slots[s].cell < 0)
+            continue;
+
+        cell_x = GRID_START_X + (slots[s].cell % GRID_COLS) * GRID_WIDTH;
+        cell_y = GRID_START_Y + (slots[s].cell / GRID_COLS) * GRID_HEIGHT;
+
+        if (cell_x < x + w && x < cell_x + GRID_WIDTH &&
+            cell_y < y + h && y < cell_y + GRID_HEIGHT) {
+            free_slot(s);
+            stats.invalidations++;
+        }
+    }
+}
+
+/**
+ * Copy the lookup statistics
+ */
+void plant_tile_get_stats(PlantTileStats *out)
+{
+    *out = stats;
+}
+
+/**
+ * Print the lookup statistics and slot usage
+ */
+void plant_tile_report(void)
+{
+    int s, used = 0;
+
+    for (s = 0; s < PLANT_TILE_SLOTS; s++) {
+        if (slots[s].cell >= 0)
+            used++;
+    }
+
+    printf("INFO: Plant tiles: %d / %d slots, %lu hits, %lu misses, %lu evictions, %lu invalidated\n",
+           used, PLANT_TILE_SLOTS, (unsigned long)stats.hits, (unsigned long)stats.misses,
+           (unsigned long)stats.evictions, (unsigned long)stats.invalidations);
+}
@@ -0,0 +1,73 @@
+/* ------------------------------------------------------------ */
+/*                Prebaked Plant Cell Tile Cache                */
+/* ------------------------------------------------------------ */
+#ifndef PLANT_TILES_H
+#define PLANT_TILES_H
+
+#include "xil_types.h"
+#include "pvz_game.h"
+
+/* One tile is a whole grid cell: clean plate with the plant frame on top */
+#define PLANT_TILE_BYTES     (GRID_WIDTH * GRID_HEIGHT * 3)
+
+/* Memory set aside for tiles; the slot count follows from it */
+#ifndef PLANT_TILE_BUDGET_BYTES
+#define PLANT_TILE_BUDGET_BYTES  (4 * 1024 * 1024)
+#endif
+
+#define PLANT_TILE_SLOTS     (PLANT_TILE_BUDGET_BYTES / PLANT_TILE_BYTES)
+
+/* Key ranges: cell = row * GRID_COLS + col, type = PlantType, frame < ANIMATION_FRAMES */
+#define PLANT_TILE_CELLS     (GRID_ROWS * GRID_COLS)
+#define PLANT_TILE_TYPES     (PLANT_PEASHOOTER + 1)
+
+/* Lookup statistics since plant_tile_init */
+typedef struct {
+    u32 hits;
+    u32 misses;
+    u32 evictions;      /* misses that had to reuse the least recently used slot */
+    u32 invalidations;  /* tiles dropped because the plate changed under them */
+} PlantTileStats;
+
+/**
+ * Empty the cache and enable or disable it
+ */
+void plant_tile_init(int enable);
+
+/* Bypass the cache (tiles are dropped, lookups miss) */
+void plant_tile_set_enabled(int enable);
+int plant_tile_enabled(void);
+
+/**
+ * Find the tile for (cell, type, frame) and mark it most recently used
+ * Returns NULL if it is not cached or the cache is disabled.
+ */
+const u8 *plant_tile_lookup(int cell, int type, int frame);
+
+/**
+ * Find the tile without touching the LRU order or the statistics
+ * Safe while another core looks up tiles too, as long as nothing is
+ * allocated or invalidated meanwhile.
+ */
+const u8 *plant_tile_peek(int cell, int type, int frame);
+
+/**
+ * Reserve a slot for (cell, type, frame), evicting the least recently
+ * used tile if the cache is full
+ * Returns the GRID_WIDTH x GRID_HEIGHT buffer for the caller to bake,
+ * or NULL if the cache is disabled or the key is out of range.
+ */
+u8 *plant_tile_alloc(int cell, int type, int frame);
+
+/**
+ * Drop every tile whose cell overlaps the rectangle
+ * Call whenever the clean plate changes under the grid.
+ */
+void plant_tile_invalidate_rect(int x, int y, int w, int h);
+void plant_tile_invalidate_all(void);
+
+/* Statistics */
+void plant_tile_get_stats(PlantTileStats *out);
+void plant_tile_report(void);
+
+#endif // PLANT_TILES_H
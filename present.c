@@ -0,0 +1,195 @@
+/* ------------------------------------------------------------ */
+/*             Present Queue (Non-Blocking Flips)               */
+/* ------------------------------------------------------------ */
+#include "present.h"
+#ifdef PVZ_HOST_THREADS
+// Host builds take no interrupts: the lock alone keeps callers apart
+#define Xil_ExceptionDisable()
+#define Xil_ExceptionEnable()
+#else
+#include "xil_exception.h"
+#endif
+#include <stdio.h>
+#include <string.h>
+
+static int num_buffers = 0;
+
+// Buffer ownership: on screen, waiting for VSYNC, being rendered (-1 = none)
+static volatile int scanout = -1;
+static volatile int pending = -1;
+static volatile int rendering = -1;
+
+// Set when a VSYNC passed with nothing to show while a frame was rendering
+static volatile u8 missed_vsync = 0;
+
+// Last buffer handed out, so buffers are reused round-robin
+static int last_acquired = 0;
+
+static PresentStats stats;
+
+// Spin lock for dual-core builds, where the renderer runs on the core
+// that does not take the VSYNC interrupt; uncontended otherwise
+static u8 queue_lock = 0;
+
+static void lock_queue(void)
+{
+    while (__atomic_test_and_set(&queue_lock, __ATOMIC_ACQUIRE))
+        ;
+}
+
+static void unlock_queue(void)
+{
+    __atomic_clear(&queue_lock, __ATOMIC_RELEASE);
+}
+
+/**
+ * Critical section against the VSYNC interrupt on this core and
+ * against the other core
+ */
+static void queue_enter(void)
+{
+    Xil_ExceptionDisable();
+    lock_queue();
+}
+
+static void queue_exit(void)
+{
+    unlock_queue();
+    Xil_ExceptionEnable();
+}
+
+/**
+ * Start with every buffer free except displayed_index (on screen)
+ */
+void present_init(int count, int displayed_index)
+{
+    if (count > PRESENT_MAX_BUFFERS) {
+        printf("WARNING: present queue supports %d buffers, not %d\n", PRESENT_MAX_BUFFERS, count);
+        count = PRESENT_MAX_BUFFERS;
+    }
+
+    queue_enter();
+    num_buffers = count;
+    scanout = displayed_index;
+    pending = -1;
+    rendering = -1;
+    missed_vsync = 0;
+    last_acquired = displayed_index;
+    memset(&stats, 0, sizeof(stats));
+    queue_exit();
+}
+
+/**
+ * Take a buffer to render into
+ * Returns -1 if every buffer is on screen or waiting for VSYNC.
+ */
+int present_acquire(void)
+{
+    int i, index = -1;
+
+    queue_enter();
+
+    if (rendering >= 0) {
+        index = rendering;
+    } else {
+        for (i = 1; i <= num_buffers; i++) {
+            int candidate = (last_acquired + i) % num_buffers;
+
+            if (candidate != scanout && candidate != pending) {
+                index = candidate;
+                rendering = index;
+                last_acquired = index;
+                missed_vsync = 0;
+                break;
+            }
+        }
+    }
+
+    queue_exit();
+    return index;
+}
+
+/**
+ * Hand a rendered buffer over to be shown at the next VSYNC
+ * Latest frame wins: an older frame still waiting is dropped.
+ */
+void present_queue(int index)
+{
+    queue_enter();
+
+    if (pending >= 0)
+        stats.dropped++;
+    if (missed_vsync)
+        stats.late++;
+
+    pending = index;
+    rendering = -1;
+    missed_vsync = 0;
+    stats.queued++;
+
+    queue_exit();
+}
+
+/**
+ * Give back an acquired buffer without showing it
+ */
+void present_release(int index)
+{
+    queue_enter();
+    if (rendering == index) {
+        rendering = -1;
+        missed_vsync = 0;
+    }
+    queue_exit();
+}
+
+/**
+ * VSYNC (VDMA frame done) handler - runs in interrupt context
+ * Returns the buffer to flip to, or -1 to keep showing the current one.
+ */
+int present_on_vsync(void)
+{
+    int next = -1;
+
+    // Interrupts are already off in the handler: only the other core to keep out
+    lock_queue();
+    stats.vsyncs++;
+
+    if (pending < 0) {
+        // Display repeats a frame; whatever is rendering has missed this VSYNC
+        if (rendering >= 0)
+            missed_vsync = 1;
+    } else {
+        // Old scanout buffer becomes free once the new one is latched
+        scanout = pending;
+        pending = -1;
+        stats.shown++;
+        next = scanout;
+    }
+
+    unlock_queue();
+    return next;
+}
+
+/**
+ * Copy the frame statistics
+ */
+void present_get_stats(PresentStats *out)
+{
+    queue_enter();
+    *out = stats;
+    queue_exit();
+}
+
+/**
+ * Print the frame statistics
+ */
+void present_report(void)
+{
+    PresentStats s;
+
+    present_get_stats(&s);
+    printf("INFO: Present: %lu queued, %lu shown, %lu dropped, %lu late, %lu vsyncs\n",
+           (unsigned long)s.queued, (unsigned long)s.shown, (unsigned long)s.dropped,
+           (unsigned long)s.late, (unsigned long)s.vsyncs);
+}
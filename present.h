@@ -0,0 +1,55 @@
+/* ------------------------------------------------------------ */
+/*             Present Queue (Non-Blocking Flips)               */
+/* ------------------------------------------------------------ */
+#ifndef PRESENT_H
+#define PRESENT_H
+
+#include "xil_types.h"
+
+/* Maximum number of framebuffers the queue can manage */
+#define PRESENT_MAX_BUFFERS  3
+
+/* Frame statistics since present_init */
+typedef struct {
+    u32 queued;         /* frames handed to present_queue */
+    u32 shown;          /* frames flipped to the display */
+    u32 dropped;        /* queued frames replaced before they were shown */
+    u32 late;           /* frames that missed a VSYNC while being rendered */
+    u32 vsyncs;         /* frame-done interrupts seen */
+} PresentStats;
+
+/**
+ * Start with every buffer free except displayed_index (on screen)
+ */
+void present_init(int num_buffers, int displayed_index);
+
+/**
+ * Take a buffer to render into
+ * Returns -1 if every buffer is on screen or waiting for VSYNC;
+ * the caller waits for the next interrupt and tries again.
+ */
+int present_acquire(void);
+
+/**
+ * Hand a rendered buffer over to be shown at the next VSYNC
+ * A frame still waiting from before is dropped and its buffer freed.
+ */
+void present_queue(int index);
+
+/**
+ * Give back an acquired buffer without showing it
+ */
+void present_release(int index);
+
+/**
+ * VSYNC (VDMA frame done) handler - call from interrupt context
+ * Returns the buffer to flip to, or -1 to keep the current one.
+ * The buffer that was on screen is handed back to the renderer.
+ */
+int present_on_vsync(void);
+
+/* Statistics */
+void present_get_stats(PresentStats *out);
+void present_report(void);
+
+#endif // PRESENT_H
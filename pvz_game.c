@@ -2,6 +2,14 @@
 /*            PVZ Game Logic (Optimized Version)                */
 /* ------------------------------------------------------------ */
 #include "pvz_game.h"
+#include "damage.h"
+#include "sprite_cache.h"
+#include "plant_tiles.h"
+#include "display_list.h"
+#include "blit_kernels.h"
+#include "scale_table.h"
+#include "render_bands.h"
+#include "clip.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
@@ -23,6 +31,46 @@ extern const unsigned char gImage_background1_hd[];
 
 // Forward declarations
 int rects_overlap(int x1, int y1, int w1, int h1, int x2, int y2, int w2, int h2);
+static void anim_phase_init(void);
+
+// Damage posted by game updates, composed once per frame by game_draw_damage
+static DamageList pending_damage;
+static TileMap pending_tiles;
+
+// Out-of-date back buffer regions posted by the sync, composed with the
+// damage but not recorded as this frame's changes
+static DamageList stale_damage;
+static TileMap stale_tiles;
+
+// Everything drawn over the background this frame, in draw order
+static DisplayList frame_list;
+
+// Position of each sprite id in frame_list (DL_NO_ID if not listed), and
+// the state whose spatial grid says which sprites a region touches
+static u16 frame_index[NUM_SPRITE_IDS];
+static const GameState *frame_game;
+
+// List the last diff (or full redraw) left on screen
+static DisplayList shown_list;
+
+// Clean plate: background with the sun bank and seed bank composited.
+// Erasing copies from here, so the UI never needs redrawing on the screen.
+static u8 clean_plate[SCREEN_WIDTH * SCREEN_HEIGHT * 3];
+static u8 plate_valid = 0;
+static int plate_sun_count;
+static u8 plate_selected[NUM_CARDS];
+
+// Set while both cores compose one frame: caches are only read
+static u8 compose_shared = 0;
+
+// How far between the previous and the newest tick moving sprites are drawn
+static float render_alpha = 1.0f;
+
+// Plants advance their frames on per-cell phases (PLANT_ANIM_PHASE)
+static u8 anim_stagger = 1;
+
+// Column bits of the cells in each row that advance on each tick
+static u16 anim_phase_cols[FRAMES_PER_UPDATE][GRID_ROWS];
 
 /* Number font - simple 7-segment style digits (10x16) */
 static const u8 digit_patterns[10][16] = {
@@ -50,7 +98,6 @@ void game_init(GameState *game)
     game->animation_counter = 0;
     game->prev_sun_count = 150;
     game->prev_selected_card = -1;
-    game->num_active_suns = 0;
     
     // Initialize cards
     game->cards[0].type = PLANT_SUNFLOWER;
@@ -70,22 +117,19 @@ void game_init(GameState *game)
             game->grid[i][j].shoot_counter = 0;
         }
     }
+    memset(game->plant_cols, 0, sizeof(game->plant_cols));
+    memset(game->plant_type_cols, 0, sizeof(game->plant_type_cols));
+    anim_phase_init();
     
     // Initialize suns
-    for (i = 0; i < MAX_SUNS; i++) {
-        game->suns[i].active = 0;
-        game->suns[i].prev_x = -1;
-    }
+    POOL_INIT(&game->sun_pool);
 
     // Initialize zombies
-    game->num_active_zombies = 0;
+    POOL_INIT(&game->zombie_pool);
     game->zombie_spawn_counter = 0;
     game->zombie_animation_counter = 0;
     game->bite_animation_counter = 0;
     for (i = 0; i < MAX_ZOMBIES; i++) {
-        game->zombies[i].active = 0;
-        game->zombies[i].prev_x = -1;
-        game->zombies[i].prev_y = -1;
         game->zombies[i].health = 0;  // Will be set to ZOMBIE_MAX_HEALTH when spawned
         game->zombies[i].state = ZOMBIE_WALKING;
         game->zombies[i].target_col = -1;
@@ -94,12 +138,11 @@ void game_init(GameState *game)
     }
 
     // Initialize peas
-    game->num_active_peas = 0;
-    for (i = 0; i < MAX_PEAS; i++) {
-        game->peas[i].active = 0;
-        game->peas[i].prev_x = -1;
-        game->peas[i].prev_y = -1;
-    }
+    POOL_INIT(&game->pea_pool);
+    memset(&game->lanes, 0, sizeof(game->lanes));
+
+    // Nothing on screen yet; sprites register as they are planted or spawn
+    SGRID_INIT(&game->sprites);
 
     printf("Game initialized: sun=%d\n", game->sun_count);
 
@@ -109,89 +152,324 @@ void game_init(GameState *game)
     game->game_over_timer = 0;
     game->fade_progress = 0.0f;
     game->defeat_scale = DEFEAT_MIN_SCALE;
+    game->tick_time = 0;
+}
+
+/* ============================================================ */
+/*                    ENTITY STORAGE                            */
+/* ============================================================ */
+
+/**
+ * x of a slot in a zombie or pea array, given the first entity's x and
+ * the entity size, so the lane helpers serve both
+ */
+#define LANE_X(x0, size, slot)  (*(const float *)((const u8 *)(x0) + (slot) * (size)))
+
+/**
+ * Add a slot to a lane list, keeping it sorted by x
+ * Zombies spawn at the right edge and peas just right of their plant,
+ * so the search from the right end is short.
+ */
+static void lane_insert(u16 *list, u16 *count, const float *x0, int size, int slot)
+{
+    int k;
+
+    for (k = *count; k > 0 && LANE_X(x0, size, list[k - 1]) > LANE_X(x0, size, slot); k--)
+        list[k] = list[k - 1];
+    list[k] = slot;
+    (*count)++;
+}
+
+/**
+ * Take a slot out of a lane list, keeping the rest in order
+ */
+static void lane_remove(u16 *list, u16 *count, int slot)
+{
+    int k = 0;
+
+    while (list[k] != slot)
+        k++;
+    memmove(list + k, list + k + 1, (*count - k - 1) * sizeof(list[0]));
+    (*count)--;
+}
+
+/**
+ * Restore x order after a move (insertion sort)
+ * Only walkers that just passed a biting zombie are out of place, so
+ * this is one compare per entity on almost every tick.
+ */
+static void lane_sort(u16 *list, int count, const float *x0, int size)
+{
+    int k, m;
+
+    for (k = 1; k < count; k++) {
+        int slot = list[k];
+
+        for (m = k; m > 0 && LANE_X(x0, size, list[m - 1]) > LANE_X(x0, size, slot); m--)
+            list[m] = list[m - 1];
+        list[m] = slot;
+    }
+}
+
+/**
+ * Register the bounds a moving sprite can be drawn in: anywhere between
+ * its previous and newest tick (blend_pos truncates a blend of the two),
+ * with a pixel of slack each side
+ * Called every tick, but the grid is only touched when the bounds
+ * change: on a whole-pixel move, and once more when a sprite stops.
+ */
+static void sprite_place(GameState *game, int id, float tick_x, float tick_y, float x, float y,
+                         int w, int h)
+{
+    int x0 = (int)((tick_x < x) ? tick_x : x) - 1;
+    int y0 = (int)((tick_y < y) ? tick_y : y) - 1;
+    int x1 = (int)((tick_x < x) ? x : tick_x) + 1;
+    int y1 = (int)((tick_y < y) ? y : tick_y) + 1;
+
+    w += x1 - x0;
+    h += y1 - y0;
+    if (!SGRID_UNCHANGED(&game->sprites, id, x0, y0, w, h))
+        SGRID_PLACE(&game->sprites, id, x0, y0, w, h);
+}
+
+static void sun_place(GameState *game, int i)
+{
+    sprite_place(game, SPRITE_ID_SUN(i), game->suns[i].tick_x, game->suns[i].tick_y,
+                 game->suns[i].x, game->suns[i].y, SUN_SIZE, SUN_SIZE);
+}
+
+static void zombie_place(GameState *game, int i)
+{
+    sprite_place(game, SPRITE_ID_ZOMBIE(i),
+                 game->zombies[i].tick_x, game->zombies[i].tick_y + ZOMBIE_Y_OFFSET,
+                 game->zombies[i].x, game->zombies[i].y + ZOMBIE_Y_OFFSET,
+                 ZOMBIE_DISPLAY_WIDTH, ZOMBIE_DISPLAY_HEIGHT);
+}
+
+static void pea_place(GameState *game, int i)
+{
+    sprite_place(game, SPRITE_ID_PEA(i), game->peas[i].tick_x, game->peas[i].tick_y,
+                 game->peas[i].x, game->peas[i].y, PEA_SIZE, PEA_SIZE);
+}
+
+/**
+ * Despawn: unregister the slot and return it to its pool
+ */
+static void sun_free(GameState *game, int i)
+{
+    SGRID_REMOVE(&game->sprites, SPRITE_ID_SUN(i));
+    POOL_FREE(&game->sun_pool, i);
+}
+
+static void zombie_free(GameState *game, int i)
+{
+    int row = game->zombies[i].row;
+
+    lane_remove(game->lanes.zombies[row], &game->lanes.zombie_count[row], i);
+    SGRID_REMOVE(&game->sprites, SPRITE_ID_ZOMBIE(i));
+    POOL_FREE(&game->zombie_pool, i);
+}
+
+static void pea_free(GameState *game, int i)
+{
+    int row = game->peas[i].row;
+
+    lane_remove(game->lanes.peas[row], &game->lanes.pea_count[row], i);
+    SGRID_REMOVE(&game->sprites, SPRITE_ID_PEA(i));
+    POOL_FREE(&game->pea_pool, i);
+}
+
+/* ============================================================ */
+/*                  TICK INTERPOLATION                          */
+/* ============================================================ */
+
+/**
+ * Remember where every moving entity is before a tick moves it
+ * Call at the start of each simulated tick; spawns set their own.
+ */
+void game_begin_tick(GameState *game)
+{
+    int n, i;
+
+    for (n = 0; n < game->sun_pool.count; n++) {
+        i = game->sun_pool.live[n];
+        game->suns[i].tick_x = game->suns[i].x;
+        game->suns[i].tick_y = game->suns[i].y;
+    }
+    for (n = 0; n < game->zombie_pool.count; n++) {
+        i = game->zombie_pool.live[n];
+        game->zombies[i].tick_x = game->zombies[i].x;
+        game->zombies[i].tick_y = game->zombies[i].y;
+    }
+    for (n = 0; n < game->pea_pool.count; n++) {
+        i = game->pea_pool.live[n];
+        game->peas[i].tick_x = game->peas[i].x;
+        game->peas[i].tick_y = game->peas[i].y;
+    }
+}
+
+/**
+ * Set the blend factor for the next display lists
+ * 0 draws the previous tick, 1 the newest (the default, no blending).
+ */
+void game_set_interpolation(float alpha)
+{
+    if (alpha < 0.0f) alpha = 0.0f;
+    if (alpha > 1.0f) alpha = 1.0f;
+    render_alpha = alpha;
+}
+
+/**
+ * Screen coordinate between the previous and the newest tick
+ * Weighted so that alpha 1 gives exactly the newest position.
+ */
+static int blend_pos(float tick_pos, float pos)
+{
+    return (int)(pos * render_alpha + tick_pos * (1.0f - render_alpha));
+}
+
+/**
+ * Per-row pixel operations used by draw_rows
+ */
+typedef enum {
+    ROW_COPY,           // opaque copy
+    ROW_KEY_NEAR_BLACK, // skip b + g + r < 30
+    ROW_KEY_BLACK,      // skip exact black
+    ROW_DARKEN          // copy at half brightness
+} RowOp;
+
+/**
+ * Apply a row operation to every visible span
+ * src is a src_w pixels wide image whose top-left pixel lands on (x, y).
+ * No per-pixel bounds or UI tests: the spans already exclude them.
+ */
+static void draw_rows(u8 *framebuf, const ClipSpans *spans, int x, int y,
+                      const u8 *src, int src_w, RowOp op)
+{
+    int b, s, py;
+
+    for (b = 0; b < spans->num_bands; b++) {
+        const ClipBand *band = &spans->bands[b];
+
+        for (py = band->y0; py < band->y1; py++) {
+            u8 *dst_row = framebuf + py * SCREEN_WIDTH * 3;
+            const u8 *src_row = src + ((py - y) * src_w - x) * 3;
+
+            for (s = 0; s < band->num_spans; s++) {
+                int x0 = band->spans[s].x0;
+                int n = band->spans[s].x1 - x0;
+
+                switch (op) {
+                    case ROW_COPY:
+                        kern->copy_row(dst_row + x0 * 3, src_row + x0 * 3, n);
+                        break;
+                    case ROW_KEY_NEAR_BLACK:
+                        kern->key_copy_row(dst_row + x0 * 3, src_row + x0 * 3, n, KERN_KEY_NEAR_BLACK);
+                        break;
+                    case ROW_KEY_BLACK:
+                        kern->key_copy_row(dst_row + x0 * 3, src_row + x0 * 3, n, KERN_KEY_BLACK);
+                        break;
+                    case ROW_DARKEN:
+                        kern->darken_row(dst_row + x0 * 3, src_row + x0 * 3, n);
+                        break;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Record the visible part of a draw as damage
+ */
+static void damage_add_spans(const ClipSpans *spans)
+{
+    damage_add(spans->x0, spans->y0, spans->x1 - spans->x0, spans->y1 - spans->y0);
 }
 
 /**
  * Draw sprite (original size)
  */
-void draw_sprite(u8 *framebuf, int x, int y, const u8 *sprite_data, int w, int h)
+void draw_sprite(u8 *framebuf, int x, int y, const u8 *sprite_data, int w, int h,
+                 const ClipRegion *clip)
 {
-    int i, j;
-    u32 fb_idx, sprite_idx;
+    ClipSpans spans;
     
     if (x < 0 || y < 0 || x + w > SCREEN_WIDTH || y + h > SCREEN_HEIGHT)
         return;
-    
-    for (i = 0; i < h; i++) {
-        for (j = 0; j < w; j++) {
-            fb_idx = ((y + i) * SCREEN_WIDTH + (x + j)) * 3;
-            sprite_idx = (i * w + j) * 3;
-            
-            framebuf[fb_idx]     = sprite_data[sprite_idx];
-            framebuf[fb_idx + 1] = sprite_data[sprite_idx + 1];
-            framebuf[fb_idx + 2] = sprite_data[sprite_idx + 2];
-        }
-    }
+
+    if (!clip_build_spans(clip, x, y, w, h, &spans))
+        return;
+
+    damage_add_spans(&spans);
+    draw_rows(framebuf, &spans, x, y, sprite_data, w, ROW_COPY);
 }
 
 /**
  * Draw sprite with transparency
  */
-void draw_sprite_transparent(u8 *framebuf, int x, int y, const u8 *sprite_data, int w, int h)
+void draw_sprite_transparent(u8 *framebuf, int x, int y, const u8 *sprite_data, int w, int h,
+                             const ClipRegion *clip)
 {
-    int i, j;
-    u32 fb_idx, sprite_idx;
-    u8 b, g, r;
+    ClipSpans spans;
 
     if (x < 0 || y < 0 || x + w > SCREEN_WIDTH || y + h > SCREEN_HEIGHT)
         return;
 
-    for (i = 0; i < h; i++) {
-        for (j = 0; j < w; j++) {
-            sprite_idx = (i * w + j) * 3;
-
-            b = sprite_data[sprite_idx];
-            g = sprite_data[sprite_idx + 1];
-            r = sprite_data[sprite_idx + 2];
+    if (!clip_build_spans(clip, x, y, w, h, &spans))
+        return;
 
-            // Treat dark colors (near-black) as transparent
-            // This handles black edges and semi-dark backgrounds
-            if ((int)b + (int)g + (int)r < 30) {
-                continue;
-            }
+    damage_add_spans(&spans);
 
-            fb_idx = ((y + i) * SCREEN_WIDTH + (x + j)) * 3;
-            framebuf[fb_idx]     = b;
-            framebuf[fb_idx + 1] = g;
-            framebuf[fb_idx + 2] = r;
-        }
+    // Encoded sprite: copy opaque runs, skip transparent ones untested
+    const RleSprite *rle = sprite_cache_static_rle(sprite_data, w, h);
+    if (rle) {
+        rle_blit(framebuf, x, y, rle, &spans);
+        return;
     }
+
+    // Treat dark colors (near-black) as transparent
+    // This handles black edges and semi-dark backgrounds
+    draw_rows(framebuf, &spans, x, y, sprite_data, w, ROW_KEY_NEAR_BLACK);
 }
 
 /**
  * Draw scaled sprite
  */
 void draw_sprite_scaled(u8 *framebuf, int dst_x, int dst_y, int dst_w, int dst_h,
-                        const u8 *sprite_data, int src_w, int src_h)
+                        const u8 *sprite_data, int src_w, int src_h, const ClipRegion *clip)
 {
-    int i, j;
-    u32 fb_idx, sprite_idx;
-    int src_x, src_y;
+    int b, s, py, px;
+    const ScaleTable *tx, *ty;
+    ClipSpans spans;
     
     if (dst_x < 0 || dst_y < 0 || dst_x + dst_w > SCREEN_WIDTH || dst_y + dst_h > SCREEN_HEIGHT)
         return;
+
+    if (!clip_build_spans(clip, dst_x, dst_y, dst_w, dst_h, &spans))
+        return;
+
+    damage_add_spans(&spans);
+
+    tx = scale_table_get(src_w, dst_w, dst_w);
+    ty = scale_table_get(src_h, dst_h, dst_h);
     
-    for (i = 0; i < dst_h; i++) {
-        for (j = 0; j < dst_w; j++) {
-            src_x = (j * src_w) / dst_w;
-            src_y = (i * src_h) / dst_h;
-            
-            fb_idx = ((dst_y + i) * SCREEN_WIDTH + (dst_x + j)) * 3;
-            sprite_idx = (src_y * src_w + src_x) * 3;
-            
-            framebuf[fb_idx]     = sprite_data[sprite_idx];
-            framebuf[fb_idx + 1] = sprite_data[sprite_idx + 1];
-            framebuf[fb_idx + 2] = sprite_data[sprite_idx + 2];
+    for (b = 0; b < spans.num_bands; b++) {
+        const ClipBand *band = &spans.bands[b];
+
+        for (py = band->y0; py < band->y1; py++) {
+            const u8 *src_row = sprite_data + ty->index[py - dst_y] * src_w * 3;
+
+            for (s = 0; s < band->num_spans; s++) {
+                u8 *dst = framebuf + (py * SCREEN_WIDTH + band->spans[s].x0) * 3;
+
+                for (px = band->spans[s].x0; px < band->spans[s].x1; px++, dst += 3) {
+                    const u8 *src = src_row + tx->index[px - dst_x] * 3;
+                    
+                    dst[0] = src[0];
+                    dst[1] = src[1];
+                    dst[2] = src[2];
+                }
+            }
         }
     }
 }
@@ -200,37 +478,47 @@ void draw_sprite_scaled(u8 *framebuf, int dst_x, int dst_y, int dst_w, int dst_h
  * Draw scaled sprite with transparency
  */
 void draw_sprite_scaled_transparent(u8 *framebuf, int dst_x, int dst_y, int dst_w, int dst_h,
-                                    const u8 *sprite_data, int src_w, int src_h)
+                                    const u8 *sprite_data, int src_w, int src_h,
+                                    const ClipRegion *clip)
 {
-    int i, j;
-    u32 fb_idx, sprite_idx;
-    int src_x, src_y;
-    u8 b, g, r;
+    int b, s, py, px;
+    const ScaleTable *tx, *ty;
+    ClipSpans spans;
 
     if (dst_x < 0 || dst_y < 0 || dst_x + dst_w > SCREEN_WIDTH || dst_y + dst_h > SCREEN_HEIGHT)
         return;
 
-    for (i = 0; i < dst_h; i++) {
-        for (j = 0; j < dst_w; j++) {
-            src_x = (j * src_w) / dst_w;
-            src_y = (i * src_h) / dst_h;
+    if (!clip_build_spans(clip, dst_x, dst_y, dst_w, dst_h, &spans))
+        return;
 
-            sprite_idx = (src_y * src_w + src_x) * 3;
+    damage_add_spans(&spans);
 
-            b = sprite_data[sprite_idx];
-            g = sprite_data[sprite_idx + 1];
-            r = sprite_data[sprite_idx + 2];
+    tx = scale_table_get(src_w, dst_w, dst_w);
+    ty = scale_table_get(src_h, dst_h, dst_h);
 
-            // Treat dark colors (near-black) as transparent
-            // This handles black edges and semi-dark backgrounds
-            if ((int)b + (int)g + (int)r < 30) {
-                continue;
-            }
+    for (b = 0; b < spans.num_bands; b++) {
+        const ClipBand *band = &spans.bands[b];
 
-            fb_idx = ((dst_y + i) * SCREEN_WIDTH + (dst_x + j)) * 3;
-            framebuf[fb_idx]     = b;
-            framebuf[fb_idx + 1] = g;
-            framebuf[fb_idx + 2] = r;
+        for (py = band->y0; py < band->y1; py++) {
+            const u8 *src_row = sprite_data + ty->index[py - dst_y] * src_w * 3;
+
+            for (s = 0; s < band->num_spans; s++) {
+                u8 *dst = framebuf + (py * SCREEN_WIDTH + band->spans[s].x0) * 3;
+
+                for (px = band->spans[s].x0; px < band->spans[s].x1; px++, dst += 3) {
+                    const u8 *src = src_row + tx->index[px - dst_x] * 3;
+
+                    // Treat dark colors (near-black) as transparent
+                    // This handles black edges and semi-dark backgrounds
+                    if ((int)src[0] + (int)src[1] + (int)src[2] < 30) {
+                        continue;
+                    }
+
+                    dst[0] = src[0];
+                    dst[1] = src[1];
+                    dst[2] = src[2];
+                }
+            }
         }
     }
 }
@@ -238,27 +526,35 @@ void draw_sprite_scaled_transparent(u8 *framebuf, int dst_x, int dst_y, int dst_
 /**
  * Draw number
  */
-void draw_number(u8 *framebuf, int x, int y, int number)
+void draw_number(u8 *framebuf, int x, int y, int number, const ClipRegion *clip)
 {
     char str[16];
-    int len, i, digit, bit, row, col;
-    u32 fb_idx;
+    int len, digit, bit, b, s, py, px;
+    ClipSpans spans;
     
     sprintf(str, "%d", number);
     len = strlen(str);
+
+    if (!clip_build_spans(clip, x, y, len * 12, 16, &spans))
+        return;
+
+    damage_add_spans(&spans);
     
-    for (i = 0; i < len; i++) {
-        digit = str[i] - '0';
-        
-        for (row = 0; row < 16; row++) {
-            for (bit = 0; bit < 8; bit++) {
-                if (digit_patterns[digit][row] & (1 << (7 - bit))) {
-                    col = x + i * 12 + bit;
-                    if (col >= 0 && col < SCREEN_WIDTH && y + row >= 0 && y + row < SCREEN_HEIGHT) {
-                        fb_idx = ((y + row) * SCREEN_WIDTH + col) * 3;
-                        framebuf[fb_idx]     = 0;
-                        framebuf[fb_idx + 1] = 0;
-                        framebuf[fb_idx + 2] = 0;
+    for (b = 0; b < spans.num_bands; b++) {
+        const ClipBand *band = &spans.bands[b];
+
+        for (py = band->y0; py < band->y1; py++) {
+            for (s = 0; s < band->num_spans; s++) {
+                for (px = band->spans[s].x0; px < band->spans[s].x1; px++) {
+                    digit = str[(px - x) / 12] - '0';
+                    bit = (px - x) % 12;
+
+                    // Glyphs are 8 pixels wide in a 12 pixel cell
+                    if (bit < 8 && (digit_patterns[digit][py - y] & (1 << (7 - bit)))) {
+                        u8 *dst = framebuf + (py * SCREEN_WIDTH + px) * 3;
+                        dst[0] = 0;
+                        dst[1] = 0;
+                        dst[2] = 0;
                     }
                 }
             }
@@ -270,120 +566,175 @@ void draw_number(u8 *framebuf, int x, int y, int number)
  * Extract and draw frame from sprite sheet with scaling and transparency
  */
 void draw_sprite_from_sheet(u8 *framebuf, int dst_x, int dst_y, int dst_w, int dst_h,
-                            const u8 *sheet_data, int frame_index)
+                            const u8 *sheet_data, int frame_index, const ClipRegion *clip)
 {
-    int i, j;
-    u32 fb_idx;
+    int b, s, py, px;
     int src_x_offset, src_y_offset;
-    int src_x, src_y;
-    u32 sheet_idx;
-    u8 b, g, r;
+    const ScaleTable *tx, *ty;
+    ClipSpans spans;
 
     if (dst_x < 0 || dst_y < 0 || dst_x + dst_w > SCREEN_WIDTH || dst_y + dst_h > SCREEN_HEIGHT)
         return;
 
+    if (!clip_build_spans(clip, dst_x, dst_y, dst_w, dst_h, &spans))
+        return;
+
+    damage_add_spans(&spans);
+
+    // Pre-scaled frame available: plain unscaled blit
+    if (dst_w == PLANT_SIZE && dst_h == PLANT_SIZE) {
+        const RleSprite *rle = sprite_cache_plant_rle(sheet_data, frame_index);
+        const u8 *frame;
+
+        if (rle) {
+            rle_blit(framebuf, dst_x, dst_y, rle, &spans);
+            return;
+        }
+
+        frame = sprite_cache_plant(sheet_data, frame_index);
+
+        if (frame) {
+            draw_rows(framebuf, &spans, dst_x, dst_y, frame, PLANT_SIZE, ROW_KEY_BLACK);
+            return;
+        }
+    }
+
     int frame_row = frame_index / SPRITE_COLS;
     int frame_col = frame_index % SPRITE_COLS;
 
     src_x_offset = frame_col * FRAME_SIZE;
     src_y_offset = frame_row * FRAME_SIZE;
 
-    for (i = 0; i < dst_h; i++) {
-        for (j = 0; j < dst_w; j++) {
-            src_x = src_x_offset + (j * FRAME_SIZE) / dst_w;
-            src_y = src_y_offset + (i * FRAME_SIZE) / dst_h;
+    tx = scale_table_get(FRAME_SIZE, dst_w, dst_w);
+    ty = scale_table_get(FRAME_SIZE, dst_h, dst_h);
 
-            sheet_idx = (src_y * SPRITE_SHEET_SIZE + src_x) * 3;
+    for (b = 0; b < spans.num_bands; b++) {
+        const ClipBand *band = &spans.bands[b];
 
-            b = sheet_data[sheet_idx];
-            g = sheet_data[sheet_idx + 1];
-            r = sheet_data[sheet_idx + 2];
+        for (py = band->y0; py < band->y1; py++) {
+            const u8 *src_row = sheet_data +
+                ((src_y_offset + ty->index[py - dst_y]) * SPRITE_SHEET_SIZE + src_x_offset) * 3;
 
-            if (b == 0 && g == 0 && r == 0) {
-                continue;
-            }
+            for (s = 0; s < band->num_spans; s++) {
+                u8 *dst = framebuf + (py * SCREEN_WIDTH + band->spans[s].x0) * 3;
 
-            fb_idx = ((dst_y + i) * SCREEN_WIDTH + (dst_x + j)) * 3;
-            framebuf[fb_idx]     = b;
-            framebuf[fb_idx + 1] = g;
-            framebuf[fb_idx + 2] = r;
+                for (px = band->spans[s].x0; px < band->spans[s].x1; px++, dst += 3) {
+                    const u8 *src = src_row + tx->index[px - dst_x] * 3;
+
+                    if (src[0] == 0 && src[1] == 0 && src[2] == 0) {
+                        continue;
+                    }
+
+                    dst[0] = src[0];
+                    dst[1] = src[1];
+                    dst[2] = src[2];
+                }
+            }
         }
     }
 }
 
 /**
  * Update animation for all plants
+ * Only the plants whose cell phase matches this tick advance, so the
+ * redraw cost is spread evenly instead of spiking every 8th tick.
  */
 int game_update_animation(GameState *game)
 {
     int i, j;
+    u16 bits;
     int frame_changed = 0;
 
     game->animation_counter++;
-
-    if (game->animation_counter >= FRAMES_PER_UPDATE) {
+    if (game->animation_counter >= FRAMES_PER_UPDATE)
         game->animation_counter = 0;
 
-        for (i = 0; i < GRID_ROWS; i++) {
-            for (j = 0; j < GRID_COLS; j++) {
-                if (game->grid[i][j].plant != PLANT_NONE) {
-                    game->grid[i][j].animation_frame++;
-                    if (game->grid[i][j].animation_frame >= ANIMATION_FRAMES) {
-                        game->grid[i][j].animation_frame = 0;
-                    }
-                    frame_changed = 1;
-                }
+    // Each plant still advances once every FRAMES_PER_UPDATE ticks, on its cell's phase
+    for (i = 0; i < GRID_ROWS; i++) {
+        bits = game->plant_cols[i] & anim_phase_cols[game->animation_counter][i];
+        for (; bits; bits &= bits - 1) {
+            j = __builtin_ctz(bits);
+            game->grid[i][j].animation_frame++;
+            if (game->grid[i][j].animation_frame >= ANIMATION_FRAMES) {
+                game->grid[i][j].animation_frame = 0;
             }
+            frame_changed = 1;
         }
     }
 
     return frame_changed;
 }
 
+/**
+ * Tabulate which cells advance on each tick for the current stagger mode
+ */
+static void anim_phase_init(void)
+{
+    int row, col;
+
+    memset(anim_phase_cols, 0, sizeof(anim_phase_cols));
+    for (row = 0; row < GRID_ROWS; row++) {
+        for (col = 0; col < GRID_COLS; col++) {
+            int phase = anim_stagger ? PLANT_ANIM_PHASE(row, col) : 0;
+
+            anim_phase_cols[phase][row] |= 1u << col;
+        }
+    }
+}
+
+/**
+ * Spread plant frame advances over the ticks (1, default) or advance
+ * every plant on the same tick (0, for comparison)
+ */
+void game_set_anim_stagger(int enable)
+{
+    anim_stagger = enable;
+    anim_phase_init();
+}
+
 /**
  * Draw darkened sprite (for selected cards)
  */
-void draw_sprite_darkened(u8 *framebuf, int x, int y, const u8 *sprite_data, int w, int h)
+void draw_sprite_darkened(u8 *framebuf, int x, int y, const u8 *sprite_data, int w, int h,
+                          const ClipRegion *clip)
 {
-    int i, j;
-    u32 fb_idx, sprite_idx;
+    ClipSpans spans;
     
     if (x < 0 || y < 0 || x + w > SCREEN_WIDTH || y + h > SCREEN_HEIGHT)
         return;
-    
-    for (i = 0; i < h; i++) {
-        for (j = 0; j < w; j++) {
-            fb_idx = ((y + i) * SCREEN_WIDTH + (x + j)) * 3;
-            sprite_idx = (i * w + j) * 3;
-            
-            framebuf[fb_idx]     = sprite_data[sprite_idx] / 2;
-            framebuf[fb_idx + 1] = sprite_data[sprite_idx + 1] / 2;
-            framebuf[fb_idx + 2] = sprite_data[sprite_idx + 2] / 2;
-        }
-    }
+
+    if (!clip_build_spans(clip, x, y, w, h, &spans))
+        return;
+
+    damage_add_spans(&spans);
+    draw_rows(framebuf, &spans, x, y, sprite_data, w, ROW_DARKEN);
 }
 
 /**
- * Restore background rectangle from original background image
+ * Copy a rectangle of a full-screen image into framebuf
  */
-void restore_background_rect(u8 *framebuf, int x, int y, int w, int h)
+static void copy_screen_rect(u8 *framebuf, const u8 *image, int x, int y, int w, int h,
+                             const ClipRegion *clip)
 {
-    int i, j;
-    u32 fb_idx;
-
-    if (x < 0) x = 0;
-    if (y < 0) y = 0;
-    if (x + w > SCREEN_WIDTH) w = SCREEN_WIDTH - x;
-    if (y + h > SCREEN_HEIGHT) h = SCREEN_HEIGHT - y;
-
-    for (i = 0; i < h; i++) {
-        for (j = 0; j < w; j++) {
-            fb_idx = ((y + i) * SCREEN_WIDTH + (x + j)) * 3;
-            framebuf[fb_idx]     = gImage_background1_hd[fb_idx];
-            framebuf[fb_idx + 1] = gImage_background1_hd[fb_idx + 1];
-            framebuf[fb_idx + 2] = gImage_background1_hd[fb_idx + 2];
-        }
-    }
+    ClipSpans spans;
+
+    if (!clip_build_spans(clip, x, y, w, h, &spans))
+        return;
+
+    damage_add_spans(&spans);
+
+    // Both images share the screen layout
+    draw_rows(framebuf, &spans, 0, 0, image, SCREEN_WIDTH, ROW_COPY);
+}
+
+/**
+ * Restore background rectangle from the clean plate
+ * The plate already holds the UI banks, so erasing never damages them.
+ * Before the first plate build this is the plain background image.
+ */
+void restore_background_rect(u8 *framebuf, int x, int y, int w, int h, const ClipRegion *clip)
+{
+    copy_screen_rect(framebuf, plate_valid ? clean_plate : gImage_background1_hd, x, y, w, h, clip);
 }
 
 /**
@@ -418,47 +769,12 @@ int is_in_ui_protected_area(int x, int y, int w, int h)
 
 /**
  * Restore background rectangle safely (avoiding UI areas)
- * CRITICAL: Completely skips pixels in UI protected areas
- * UI areas are treated as immutable - they are NEVER erased
+ * UI areas are treated as immutable - they are part of the clean plate,
+ * so a plain copy restores them unchanged
  */
 void restore_background_rect_safe(u8 *framebuf, int x, int y, int w, int h)
 {
-    int i, j;
-    u32 fb_idx;
-
-    // Boundary check
-    if (x < 0) { w += x; x = 0; }
-    if (y < 0) { h += y; y = 0; }
-    if (x + w > SCREEN_WIDTH) w = SCREEN_WIDTH - x;
-    if (y + h > SCREEN_HEIGHT) h = SCREEN_HEIGHT - y;
-
-    if (w <= 0 || h <= 0) return;
-
-    // Restore pixel by pixel, skipping UI areas
-    for (i = 0; i < h; i++) {
-        for (j = 0; j < w; j++) {
-            int px = x + j;
-            int py = y + i;
-
-            // Check if this pixel is in SEED BANK area
-            if (px >= UI_SEEDBANK_X && px < UI_SEEDBANK_X + UI_SEEDBANK_WIDTH &&
-                py >= UI_SEEDBANK_Y && py < UI_SEEDBANK_Y + UI_SEEDBANK_HEIGHT) {
-                continue;  // Skip - don't touch seed bank pixels
-            }
-
-            // Check if this pixel is in SUN BANK area
-            if (px >= UI_SUNBANK_X && px < UI_SUNBANK_X + UI_SUNBANK_WIDTH &&
-                py >= UI_SUNBANK_Y && py < UI_SUNBANK_Y + UI_SUNBANK_HEIGHT) {
-                continue;  // Skip - don't touch sun bank pixels
-            }
-
-            // Safe to restore this pixel
-            fb_idx = (py * SCREEN_WIDTH + px) * 3;
-            framebuf[fb_idx]     = gImage_background1_hd[fb_idx];
-            framebuf[fb_idx + 1] = gImage_background1_hd[fb_idx + 1];
-            framebuf[fb_idx + 2] = gImage_background1_hd[fb_idx + 2];
-        }
-    }
+    restore_background_rect(framebuf, x, y, w, h, NULL);
 }
 
 /**
@@ -471,188 +787,741 @@ int rects_overlap(int x1, int y1, int w1, int h1,
              y1 + h1 <= y2 || y2 + h2 <= y1);
 }
 
+/**
+ * Draw the sun bank with the current sun count
+ */
+static void draw_sun_bank(GameState *game, u8 *framebuf, const ClipRegion *clip)
+{
+    copy_screen_rect(framebuf, gImage_background1_hd,
+                     SUNBANK_X, SUNBANK_Y, SUNBANK_DRAW_WIDTH, SUNBANK_DRAW_HEIGHT, clip);
+    draw_sprite_transparent(framebuf, SUNBANK_X, SUNBANK_Y, gImage_SunBank, 63, 70, clip);
+    draw_number(framebuf, SUNBANK_X + 10, SUNBANK_Y + 45, game->sun_count, clip);
+}
+
+/**
+ * Draw the seed bank and its cards
+ */
+static void draw_seed_bank(GameState *game, u8 *framebuf, const ClipRegion *clip)
+{
+    int i;
+    int card_x, card_y;
+    const u8 *plant_data;
+    int bank_width = SEEDBANK_DRAW_WIDTH;
+
+    // Seed bank background
+    copy_screen_rect(framebuf, gImage_background1_hd,
+                     SEEDBANK_X, SEEDBANK_Y, bank_width, SEEDBANK_DRAW_HEIGHT, clip);
+    draw_sprite_transparent(framebuf, SEEDBANK_X, SEEDBANK_Y, gImage_SeedBank, bank_width, SEEDBANK_DRAW_HEIGHT, clip);
+
+    // Seed cards
+    for (i = 0; i < NUM_CARDS; i++) {
+        card_x = SEEDBANK_X + 10 + i * (CARD_WIDTH + CARD_SPACING);
+        card_y = SEEDBANK_Y + 5;
+
+        // Draw card background
+        if (game->cards[i].selected) {
+            draw_sprite_darkened(framebuf, card_x, card_y, gImage_SeedPacket, CARD_WIDTH, CARD_HEIGHT, clip);
+        } else {
+            draw_sprite(framebuf, card_x, card_y, gImage_SeedPacket, CARD_WIDTH, CARD_HEIGHT, clip);
+        }
+
+        // Draw plant icon
+        plant_data = (game->cards[i].type == PLANT_SUNFLOWER) ? gImage_SunFlower : gImage_PeaShooter;
+        int icon_x = card_x + (CARD_WIDTH - PLANT_ICON_SIZE) / 2;
+        int icon_y = card_y + 5;
+
+        draw_sprite_scaled_transparent(framebuf, icon_x, icon_y, PLANT_ICON_SIZE, PLANT_ICON_SIZE,
+                                      plant_data, 90, 90, clip);
+
+        // Darken the selected icon in place, inside the same clip
+        if (game->cards[i].selected) {
+            ClipSpans spans;
+
+            if (clip_build_spans(clip, icon_x, icon_y, PLANT_ICON_SIZE, PLANT_ICON_SIZE, &spans)) {
+                draw_rows(framebuf, &spans, icon_x, icon_y,
+                          framebuf + (icon_y * SCREEN_WIDTH + icon_x) * 3, SCREEN_WIDTH, ROW_DARKEN);
+            }
+        }
+    }
+}
+
 /**
  * Redraw UI elements if they were erased
  * This prevents zombies/suns from clearing the UI
+ * The banks are part of the clean plate: only the erased area is copied back.
  */
 void redraw_ui_if_overlapped(GameState *game, u8 *framebuf,
                              int erase_x, int erase_y, int erase_w, int erase_h)
 {
-    int i;
-    int card_x, card_y;
-    const u8 *plant_data;
-    int bank_width = 357;
+    ClipRegion clip;
+
+    plate_update(game);
+    clip_region_init(&clip, erase_x, erase_y, erase_w, erase_h);
 
     // Check if erase area overlaps with sun bank
     if (rects_overlap(erase_x, erase_y, erase_w, erase_h,
-                     SUNBANK_X, SUNBANK_Y, 93, 70)) {
-        // Redraw sun bank
-        restore_background_rect(framebuf, SUNBANK_X, SUNBANK_Y, 93, 70);
-        draw_sprite_transparent(framebuf, SUNBANK_X, SUNBANK_Y, gImage_SunBank, 63, 70);
-        draw_number(framebuf, SUNBANK_X + 10, SUNBANK_Y + 45, game->sun_count);
+                     SUNBANK_X, SUNBANK_Y, SUNBANK_DRAW_WIDTH, SUNBANK_DRAW_HEIGHT)) {
+        restore_background_rect(framebuf, SUNBANK_X, SUNBANK_Y,
+                                SUNBANK_DRAW_WIDTH, SUNBANK_DRAW_HEIGHT, &clip);
     }
 
     // Check if erase area overlaps with seed bank
     if (rects_overlap(erase_x, erase_y, erase_w, erase_h,
-                     SEEDBANK_X, SEEDBANK_Y, bank_width, 70)) {
-        // Redraw seed bank background
-        restore_background_rect(framebuf, SEEDBANK_X, SEEDBANK_Y, bank_width, 70);
-        draw_sprite_transparent(framebuf, SEEDBANK_X, SEEDBANK_Y, gImage_SeedBank, bank_width, 70);
-
-        // Redraw seed cards
-        for (i = 0; i < NUM_CARDS; i++) {
-            card_x = SEEDBANK_X + 10 + i * (CARD_WIDTH + CARD_SPACING);
-            card_y = SEEDBANK_Y + 5;
-
-            // Draw card background
-            if (game->cards[i].selected) {
-                draw_sprite_darkened(framebuf, card_x, card_y, gImage_SeedPacket, CARD_WIDTH, CARD_HEIGHT);
-            } else {
-                draw_sprite(framebuf, card_x, card_y, gImage_SeedPacket, CARD_WIDTH, CARD_HEIGHT);
-            }
+                     SEEDBANK_X, SEEDBANK_Y, SEEDBANK_DRAW_WIDTH, SEEDBANK_DRAW_HEIGHT)) {
+        restore_background_rect(framebuf, SEEDBANK_X, SEEDBANK_Y,
+                                SEEDBANK_DRAW_WIDTH, SEEDBANK_DRAW_HEIGHT, &clip);
+    }
+}
 
-            // Draw plant icon
-            plant_data = (game->cards[i].type == PLANT_SUNFLOWER) ? gImage_SunFlower : gImage_PeaShooter;
-            int icon_x = card_x + (CARD_WIDTH - PLANT_ICON_SIZE) / 2;
-            int icon_y = card_y + 5;
-
-            draw_sprite_scaled_transparent(framebuf, icon_x, icon_y, PLANT_ICON_SIZE, PLANT_ICON_SIZE,
-                                          plant_data, 90, 90);
-
-            if (game->cards[i].selected) {
-                int px, py;
-                for (py = 0; py < PLANT_ICON_SIZE; py++) {
-                    for (px = 0; px < PLANT_ICON_SIZE; px++) {
-                        u32 idx = ((icon_y + py) * SCREEN_WIDTH + (icon_x + px)) * 3;
-                        framebuf[idx] /= 2;
-                        framebuf[idx + 1] /= 2;
-                        framebuf[idx + 2] /= 2;
-                    }
+/* ============================================================ */
+/*                       CLEAN PLATE                            */
+/* ============================================================ */
+
+/**
+ * Bring the clean plate up to date with the sun count and card selection
+ * Only a bank whose contents changed is redrawn into the plate; its area
+ * is posted as damage so the next composition copies it to the screen.
+ */
+void plate_update(GameState *game)
+{
+    int i;
+    int seeds_changed = 0;
+
+    if (!plate_valid) {
+        memcpy(clean_plate, gImage_background1_hd, sizeof(clean_plate));
+        plate_valid = 1;
+        plant_tile_invalidate_all();
+        plate_sun_count = game->sun_count + 1;  // force both banks
+        seeds_changed = 1;
+    }
+
+    for (i = 0; i < NUM_CARDS; i++) {
+        if (plate_selected[i] != game->cards[i].selected) {
+            plate_selected[i] = game->cards[i].selected;
+            seeds_changed = 1;
+        }
+    }
+
+    if (plate_sun_count != game->sun_count) {
+        plate_sun_count = game->sun_count;
+        draw_sun_bank(game, clean_plate, NULL);
+        plant_tile_invalidate_rect(SUNBANK_X, SUNBANK_Y, SUNBANK_DRAW_WIDTH, SUNBANK_DRAW_HEIGHT);
+        game_post_damage(SUNBANK_X, SUNBANK_Y, SUNBANK_DRAW_WIDTH, SUNBANK_DRAW_HEIGHT);
+    }
+
+    if (seeds_changed) {
+        draw_seed_bank(game, clean_plate, NULL);
+        plant_tile_invalidate_rect(SEEDBANK_X, SEEDBANK_Y, SEEDBANK_DRAW_WIDTH, SEEDBANK_DRAW_HEIGHT);
+        game_post_damage(SEEDBANK_X, SEEDBANK_Y, SEEDBANK_DRAW_WIDTH, SEEDBANK_DRAW_HEIGHT);
+    }
+}
+
+/* ============================================================ */
+/*                    PLANT CELL TILES                          */
+/* ============================================================ */
+
+/**
+ * Get the prebaked tile of one planted cell, baking it on a miss
+ * The tile is what composition would leave in the cell with no other
+ * sprite on top: clean plate, then the plant frame keyed on black
+ * and hidden under the banks. Drawing it is a plain row copy.
+ * Returns NULL if tiles are off, the plate is not built yet or the
+ * frame is not pre-scaled; the caller then draws the plant itself.
+ */
+static const u8 *plant_cell_tile(int row, int col, int type, int frame_index)
+{
+    int index = row * GRID_COLS + col;
+    int cell_x = GRID_START_X + col * GRID_WIDTH;
+    int cell_y = GRID_START_Y + row * GRID_HEIGHT;
+    int plant_x = PLANT_DRAW_X(col);
+    int plant_y = PLANT_DRAW_Y(row);
+    const u8 *tile, *frame;
+    u8 *bake;
+    int b, s, py;
+    ClipRegion clip;
+    ClipSpans spans;
+
+    // Every tile the frame needs was baked before the bands started
+    if (compose_shared)
+        return plant_tile_peek(index, type, frame_index);
+
+    tile = plant_tile_lookup(index, type, frame_index);
+    if (tile || !plant_tile_enabled() || !plate_valid)
+        return tile;
+
+    frame = sprite_cache_plant((type == PLANT_SUNFLOWER) ? gImage_SunFlower_ani : gImage_PeaShooter_ani,
+                               frame_index);
+    if (!frame)
+        return NULL;
+
+    bake = plant_tile_alloc(index, type, frame_index);
+    if (!bake)
+        return NULL;
+
+    for (py = 0; py < GRID_HEIGHT; py++) {
+        memcpy(bake + py * GRID_WIDTH * 3,
+               clean_plate + ((cell_y + py) * SCREEN_WIDTH + cell_x) * 3, GRID_WIDTH * 3);
+    }
+
+    clip_region_init(&clip, plant_x, plant_y, PLANT_SIZE, PLANT_SIZE);
+    clip_region_exclude(&clip, SUNBANK_X, SUNBANK_Y, SUNBANK_DRAW_WIDTH, SUNBANK_DRAW_HEIGHT);
+    clip_region_exclude(&clip, SEEDBANK_X, SEEDBANK_Y, SEEDBANK_DRAW_WIDTH, SEEDBANK_DRAW_HEIGHT);
+
+    if (clip_build_spans(&clip, plant_x, plant_y, PLANT_SIZE, PLANT_SIZE, &spans)) {
+        for (b = 0; b < spans.num_bands; b++) {
+            const ClipBand *band = &spans.bands[b];
+
+            for (py = band->y0; py < band->y1; py++) {
+                u8 *dst_row = bake + ((py - cell_y) * GRID_WIDTH - cell_x) * 3;
+                const u8 *src_row = frame + ((py - plant_y) * PLANT_SIZE - plant_x) * 3;
+
+                for (s = 0; s < band->num_spans; s++) {
+                    int x0 = band->spans[s].x0;
+
+                    kern->key_copy_row(dst_row + x0 * 3, src_row + x0 * 3,
+                                       band->spans[s].x1 - x0, KERN_KEY_BLACK);
                 }
             }
         }
     }
+
+    return bake;
 }
 
+/* ============================================================ */
+/*                   DAMAGE COMPOSITION                         */
+/* ============================================================ */
+
 /**
- * OPTIMIZED: Draw only plants (for animation updates)
- * This function only redraws grid cells that have plants
- * Skips UI elements and empty cells completely
+ * Post a dirty rectangle to be redrawn by the next game_draw_damage
  */
-void game_draw_animation(GameState *game, u8 *framebuf)
+void game_post_damage(int x, int y, int w, int h)
 {
-    int i, j;
+    if (damage_get_mode() == DAMAGE_MODE_TILES)
+        tilemap_mark_rect(&pending_tiles, x, y, w, h);
+    else
+        damage_list_add(&pending_damage, x, y, w, h);
+}
 
-    // Only iterate through grid cells that have plants
-    for (i = 0; i < GRID_ROWS; i++) {
-        for (j = 0; j < GRID_COLS; j++) {
-            if (game->grid[i][j].plant != PLANT_NONE) {
-                // Calculate cell position
-                int cell_x = GRID_START_X + j * GRID_WIDTH;
-                int cell_y = GRID_START_Y + i * GRID_HEIGHT;
+/**
+ * Post a back buffer region that is out of date but unchanged by this
+ * frame, to be brought up to date by the next game_draw_damage
+ */
+void game_post_stale(int x, int y, int w, int h)
+{
+    if (damage_get_mode() == DAMAGE_MODE_TILES)
+        tilemap_mark_rect(&stale_tiles, x, y, w, h);
+    else
+        damage_list_add(&stale_damage, x, y, w, h);
+}
+
+/**
+ * Emit a draw command for everything drawn on top of the background
+ * and sort the list into draw order: plants, suns, zombies, peas
+ * The UI banks are part of the clean plate and not in the list.
+ */
+void game_build_display_list(const GameState *game, DisplayList *list)
+{
+    int n, i, row, col;
+    u16 bits;
+
+    displist_clear(list);
 
-                // Restore background for this cell only
-                restore_background_rect(framebuf, cell_x, cell_y, GRID_WIDTH, GRID_HEIGHT);
+    for (row = 0; row < GRID_ROWS; row++) {
+        for (bits = game->plant_cols[row]; bits; bits &= bits - 1) {
+            col = __builtin_ctz(bits);
+            const GridCell *cell = &game->grid[row][col];
+
+            displist_add(list,
+                         (cell->plant == PLANT_SUNFLOWER) ? DL_SPRITE_SUNFLOWER : DL_SPRITE_PEASHOOTER,
+                         cell->animation_frame, PLANT_DRAW_X(col), PLANT_DRAW_Y(row),
+                         PLANT_SIZE, PLANT_SIZE, DL_LAYER_PLANT, DL_CLIP_UNDER_UI,
+                         SPRITE_ID_PLANT(row, col));
+        }
+    }
 
-                // Draw the animated plant
-                int plant_x = cell_x + (GRID_WIDTH - PLANT_SIZE) / 2;
-                int plant_y = cell_y + (GRID_HEIGHT - PLANT_SIZE) / 2;
+    for (n = 0; n < game->sun_pool.count; n++) {
+        i = game->sun_pool.live[n];
+        const Sun *sun = &game->suns[i];
 
-                const u8 *sheet_data = (game->grid[i][j].plant == PLANT_SUNFLOWER) ?
-                                       gImage_SunFlower_ani : gImage_PeaShooter_ani;
+        displist_add(list, DL_SPRITE_SUN, 0, blend_pos(sun->tick_x, sun->x), blend_pos(sun->tick_y, sun->y),
+                     SUN_SIZE, SUN_SIZE, DL_LAYER_SUN, DL_CLIP_UNDER_UI, SPRITE_ID_SUN(i));
+    }
 
-                draw_sprite_from_sheet(framebuf, plant_x, plant_y, PLANT_SIZE, PLANT_SIZE,
-                                      sheet_data, game->grid[i][j].animation_frame);
-            }
+    for (n = 0; n < game->zombie_pool.count; n++) {
+        i = game->zombie_pool.live[n];
+        const Zombie *zombie = &game->zombies[i];
+        int x, y;
+
+        x = blend_pos(zombie->tick_x, zombie->x);
+        y = blend_pos(zombie->tick_y, zombie->y) + ZOMBIE_Y_OFFSET;
+
+        // Drawn rectangle includes the sprite's vertical offset
+        if (zombie->state == ZOMBIE_WALKING) {
+            displist_add(list, DL_SPRITE_ZOMBIE_WALK, zombie->animation_frame, x, y,
+                         ZOMBIE_DISPLAY_WIDTH, ZOMBIE_DISPLAY_HEIGHT, DL_LAYER_ZOMBIE, DL_CLIP_UNDER_UI,
+                         SPRITE_ID_ZOMBIE(i));
+        } else if (zombie->state == ZOMBIE_BITING) {
+            displist_add(list, DL_SPRITE_ZOMBIE_BITE, zombie->bite_anim_frame, x, y,
+                         ZOMBIE_DISPLAY_WIDTH, ZOMBIE_DISPLAY_HEIGHT, DL_LAYER_ZOMBIE, DL_CLIP_UNDER_UI,
+                         SPRITE_ID_ZOMBIE(i));
         }
     }
 
-    // DO NOT update tracking variables here - only full draw should do that
-    // This prevents interfering with change detection in timer handler
+    for (n = 0; n < game->pea_pool.count; n++) {
+        i = game->pea_pool.live[n];
+        const Pea *pea = &game->peas[i];
+
+        displist_add(list, DL_SPRITE_PEA, 0, blend_pos(pea->tick_x, pea->x), blend_pos(pea->tick_y, pea->y),
+                     PEA_SIZE, PEA_SIZE, DL_LAYER_PEA, DL_CLIP_UNDER_UI, SPRITE_ID_PEA(i));
+    }
+
+    displist_sort(list);
 }
 
 /**
- * FULL REDRAW: Draw complete game state (UI + all plants)
- * Called when: initial draw, planting, or UI state changes
+ * Display list of the last composed frame
  */
-void game_draw_full(GameState *game, u8 *framebuf)
+const DisplayList *game_display_list(void)
+{
+    return &frame_list;
+}
+
+/**
+ * Draw the part of one display list command inside clip
+ * Commands carry everything needed, so this never looks at game state.
+ */
+void game_draw_command(u8 *framebuf, const DrawCmd *cmd, const ClipRegion *clip)
+{
+    switch (cmd->sprite) {
+        case DL_SPRITE_SUNFLOWER:
+        case DL_SPRITE_PEASHOOTER: {
+            int type = (cmd->sprite == DL_SPRITE_SUNFLOWER) ? PLANT_SUNFLOWER : PLANT_PEASHOOTER;
+            int col = (cmd->x - GRID_START_X) / GRID_WIDTH;
+            int row = (cmd->y - GRID_START_Y) / GRID_HEIGHT;
+            const u8 *tile = NULL;
+
+            // Plants are drawn first, so the cell still holds the bare plate
+            if (row >= 0 && row < GRID_ROWS && col >= 0 && col < GRID_COLS &&
+                cmd->x == PLANT_DRAW_X(col) && cmd->y == PLANT_DRAW_Y(row))
+                tile = plant_cell_tile(row, col, type, cmd->frame);
+
+            if (tile) {
+                draw_sprite(framebuf, GRID_START_X + col * GRID_WIDTH, GRID_START_Y + row * GRID_HEIGHT,
+                            tile, GRID_WIDTH, GRID_HEIGHT, clip);
+                break;
+            }
+
+            draw_sprite_from_sheet(framebuf, cmd->x, cmd->y, cmd->w, cmd->h,
+                                   (type == PLANT_SUNFLOWER) ? gImage_SunFlower_ani : gImage_PeaShooter_ani,
+                                   cmd->frame, clip);
+            break;
+        }
+        case DL_SPRITE_SUN:
+            draw_sprite_transparent(framebuf, cmd->x, cmd->y, gImage_Sun, SUN_SIZE, SUN_SIZE, clip);
+            break;
+        case DL_SPRITE_ZOMBIE_WALK:
+            draw_zombie_sprite(framebuf, cmd->x, cmd->y - ZOMBIE_Y_OFFSET,
+                               gImage_walk_ani, cmd->frame, clip);
+            break;
+        case DL_SPRITE_ZOMBIE_BITE:
+            draw_bite_sprite(framebuf, cmd->x, cmd->y - ZOMBIE_Y_OFFSET,
+                             gImage_bite_ani, cmd->frame, clip);
+            break;
+        case DL_SPRITE_PEA:
+            draw_sprite_transparent(framebuf, cmd->x, cmd->y, gImage_ProjectilePea, PEA_SIZE, PEA_SIZE, clip);
+            break;
+    }
+}
+
+/**
+ * Merge overlapping posted rectangles into their bounding boxes
+ * Sprites are redrawn clipped to each region, so regions no longer
+ * have to grow over the sprites they touch; merging only stops the
+ * shared area from being composed twice.
+ */
+static void damage_coalesce(DamageList *list)
 {
     int i, j;
-    int card_x, card_y;
-    const u8 *plant_data;
 
-    // Draw UI elements (sun bank and seed cards)
-    
-    // Draw sun bank area
-    restore_background_rect(framebuf, SUNBANK_X, SUNBANK_Y, 93, 70);
-    draw_sprite_transparent(framebuf, SUNBANK_X, SUNBANK_Y, gImage_SunBank, 63, 70);
-    draw_number(framebuf, SUNBANK_X + 10, SUNBANK_Y + 45, game->sun_count);
+    if (list->full) {
+        // Whole screen is one region
+        list->full = 0;
+        list->count = 1;
+        list->rects[0].x = 0;
+        list->rects[0].y = 0;
+        list->rects[0].w = SCREEN_WIDTH;
+        list->rects[0].h = SCREEN_HEIGHT;
+        return;
+    }
 
-    // Draw seed bank area
-    int bank_width = 357;
-    restore_background_rect(framebuf, SEEDBANK_X, SEEDBANK_Y, bank_width, 70);
-    draw_sprite_transparent(framebuf, SEEDBANK_X, SEEDBANK_Y, gImage_SeedBank, bank_width, 70);
+    for (i = 0; i < list->count; i++) {
+        for (j = i + 1; j < list->count; j++) {
+            DamageRect *a = &list->rects[i];
+            DamageRect *b = &list->rects[j];
+
+            if (rects_overlap(a->x, a->y, a->w, a->h, b->x, b->y, b->w, b->h)) {
+                int x1 = (a->x + a->w > b->x + b->w) ? a->x + a->w : b->x + b->w;
+                int y1 = (a->y + a->h > b->y + b->h) ? a->y + a->h : b->y + b->h;
+                if (b->x < a->x) a->x = b->x;
+                if (b->y < a->y) a->y = b->y;
+                a->w = x1 - a->x;
+                a->h = y1 - a->y;
+
+                list->rects[j] = list->rects[--list->count];
+                j = i;  // Rescan against the grown rect
+            }
+        }
+    }
+}
 
-    // Draw seed cards
-    for (i = 0; i < NUM_CARDS; i++) {
-        card_x = SEEDBANK_X + 10 + i * (CARD_WIDTH + CARD_SPACING);
-        card_y = SEEDBANK_Y + 5;
-        
-        // Draw card background
-        if (game->cards[i].selected) {
-            draw_sprite_darkened(framebuf, card_x, card_y, gImage_SeedPacket, CARD_WIDTH, CARD_HEIGHT);
-        } else {
-            draw_sprite(framebuf, card_x, card_y, gImage_SeedPacket, CARD_WIDTH, CARD_HEIGHT);
+/**
+ * Compose one region: clean plate, then the display list clipped to it
+ * The banks stay on top of every sprite, as if drawn last.
+ */
+static void game_compose_rect(u8 *framebuf, const DisplayList *list, int x, int y, int w, int h)
+{
+    ClipRegion clip;
+
+    clip_region_init(&clip, x, y, w, h);
+    restore_background_rect(framebuf, x, y, w, h, &clip);
+    displist_draw_rect(list, framebuf, x, y, w, h);
+}
+
+/**
+ * Map sprite ids to their commands in the freshly built frame list
+ */
+static void index_frame_list(const GameState *game)
+{
+    int i;
+
+    memset(frame_index, 0xFF, sizeof(frame_index));
+    for (i = 0; i < frame_list.count; i++) {
+        if (frame_list.cmds[i].id != DL_NO_ID)
+            frame_index[frame_list.cmds[i].id] = i;
+    }
+    frame_game = game;
+}
+
+static void mark_sprite(int id, void *arg)
+{
+    u32 *marked = (u32 *)arg;
+    int i = frame_index[id];
+
+    if (i != DL_NO_ID)
+        marked[i / 32] |= 1u << (i % 32);
+}
+
+/**
+ * Compose one region of the frame list: like game_compose_rect, but
+ * only the sprites the spatial grid finds in the region are tested,
+ * instead of every command in the list
+ */
+static void compose_frame_rect(u8 *framebuf, int x, int y, int w, int h)
+{
+    ClipRegion clip;
+    u32 marked[DL_MARK_WORDS];
+
+    clip_region_init(&clip, x, y, w, h);
+    restore_background_rect(framebuf, x, y, w, h, &clip);
+
+    memset(marked, 0, sizeof(marked));
+    SGRID_QUERY(&frame_game->sprites, x, y, w, h, mark_sprite, marked);
+    displist_draw_marked(&frame_list, marked, framebuf, x, y, w, h);
+}
+
+/**
+ * Draw a whole display list over the background, e.g. a captured one
+ */
+void game_draw_display_list(u8 *framebuf, const DisplayList *list)
+{
+    game_compose_rect(framebuf, list, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+}
+
+/**
+ * Compose the part of one damaged region inside rows y0 <= y < y1
+ */
+static void compose_rows(u8 *framebuf, int x, int y, int w, int h, int y0, int y1)
+{
+    int top = (y > y0) ? y : y0;
+    int bottom = (y + h < y1) ? y + h : y1;
+
+    if (top < bottom)
+        compose_frame_rect(framebuf, x, top, w, bottom - top);
+}
+
+/**
+ * Compose the pending damage inside rows y0 <= y < y1
+ * Tile mode goes one run of dirty tiles at a time; each region is
+ * self-contained: background, then sprites clipped to it. Only reads
+ * the pending damage, so both cores can run it on different rows.
+ */
+static void compose_pending(u8 *framebuf, int y0, int y1)
+{
+    int i, row = y0 / TILE_H, col = 0, len;
+
+    if (damage_get_mode() == DAMAGE_MODE_TILES) {
+        while (tilemap_next_run(&pending_tiles, &row, &col, &len) && row * TILE_H < y1) {
+            compose_rows(framebuf, col * TILE_W, row * TILE_H, len * TILE_W, TILE_H, y0, y1);
+            col += len;
         }
-        
-        // Draw plant icon
-        plant_data = (game->cards[i].type == PLANT_SUNFLOWER) ? gImage_SunFlower : gImage_PeaShooter;
-        int icon_x = card_x + (CARD_WIDTH - PLANT_ICON_SIZE) / 2;
-        int icon_y = card_y + 5;
-        
-        draw_sprite_scaled_transparent(framebuf, icon_x, icon_y, PLANT_ICON_SIZE, PLANT_ICON_SIZE,
-                                       plant_data, 90, 90);
+        return;
+    }
 
-        if (game->cards[i].selected) {
-            for (int py = 0; py < PLANT_ICON_SIZE; py++) {
-                for (int px = 0; px < PLANT_ICON_SIZE; px++) {
-                    u32 idx = ((icon_y + py) * SCREEN_WIDTH + (icon_x + px)) * 3;
-                    framebuf[idx] /= 2;
-                    framebuf[idx + 1] /= 2;
-                    framebuf[idx + 2] /= 2;
-                }
-            }
+    for (i = 0; i < pending_damage.count; i++) {
+        const DamageRect *r = &pending_damage.rects[i];
+        compose_rows(framebuf, r->x, r->y, r->w, r->h, y0, y1);
+    }
+}
+
+/**
+ * Check whether a rectangle touches the pending damage
+ */
+static int pending_overlaps(int x, int y, int w, int h)
+{
+    int i;
+
+    if (damage_get_mode() == DAMAGE_MODE_TILES)
+        return tilemap_test_rect(&pending_tiles, x, y, w, h);
+
+    for (i = 0; i < pending_damage.count; i++) {
+        const DamageRect *r = &pending_damage.rects[i];
+        if (rects_overlap(x, y, w, h, r->x, r->y, r->w, r->h))
+            return 1;
+    }
+    return 0;
+}
+
+/**
+ * Pixels covered by the pending damage
+ */
+static int pending_area(void)
+{
+    if (damage_get_mode() == DAMAGE_MODE_TILES)
+        return tilemap_count(&pending_tiles) * TILE_W * TILE_H;
+    return damage_list_area(&pending_damage);
+}
+
+/**
+ * Fill every cache entry a command will draw from
+ * Lazily filled caches must not be filled from two cores at once.
+ */
+static void warm_command(const DrawCmd *cmd)
+{
+    switch (cmd->sprite) {
+        case DL_SPRITE_SUNFLOWER:
+        case DL_SPRITE_PEASHOOTER: {
+            int type = (cmd->sprite == DL_SPRITE_SUNFLOWER) ? PLANT_SUNFLOWER : PLANT_PEASHOOTER;
+            int col = (cmd->x - GRID_START_X) / GRID_WIDTH;
+            int row = (cmd->y - GRID_START_Y) / GRID_HEIGHT;
+
+            sprite_cache_plant((type == PLANT_SUNFLOWER) ? gImage_SunFlower_ani : gImage_PeaShooter_ani,
+                               cmd->frame);
+            if (row >= 0 && row < GRID_ROWS && col >= 0 && col < GRID_COLS &&
+                cmd->x == PLANT_DRAW_X(col) && cmd->y == PLANT_DRAW_Y(row))
+                plant_cell_tile(row, col, type, cmd->frame);
+            break;
+        }
+        case DL_SPRITE_ZOMBIE_WALK:
+            sprite_cache_walk(cmd->frame);
+            break;
+        case DL_SPRITE_ZOMBIE_BITE:
+            sprite_cache_bite(cmd->frame);
+            break;
+        default:
+            // Static sprites are encoded when the cache is initialised
+            break;
+    }
+}
+
+static void compose_band(int y0, int y1, void *arg)
+{
+    compose_pending((u8 *)arg, y0, y1);
+}
+
+/**
+ * Compose the pending damage with both cores, one band of rows at a time
+ * Everything with side effects happens here first: the regions are
+ * recorded as damage up front and the caches are filled for every
+ * command that will be drawn, so the bands only read shared state.
+ */
+static void compose_banded(u8 *framebuf)
+{
+    int i;
+
+    for (i = 0; i < frame_list.count; i++) {
+        const DrawCmd *cmd = &frame_list.cmds[i];
+        if (pending_overlaps(cmd->x, cmd->y, cmd->w, cmd->h))
+            warm_command(cmd);
+    }
+
+    // The other core's writes sit in its own L1 until flushed by address
+    damage_mark_shared();
+    compose_shared = 1;
+    bands_run(compose_band, framebuf);
+    compose_shared = 0;
+}
+
+/**
+ * Record the pending damage as this frame's changes
+ */
+static void record_pending(void)
+{
+    int i, row = 0, col = 0, len;
+
+    if (damage_get_mode() == DAMAGE_MODE_TILES) {
+        while (tilemap_next_run(&pending_tiles, &row, &col, &len)) {
+            damage_add(col * TILE_W, row * TILE_H, len * TILE_W, TILE_H);
+            col += len;
+        }
+    } else if (pending_damage.full) {
+        damage_add_full();
+    } else {
+        for (i = 0; i < pending_damage.count; i++) {
+            const DamageRect *r = &pending_damage.rects[i];
+            damage_add(r->x, r->y, r->w, r->h);
         }
     }
+}
+
+/**
+ * Check whether the sync posted any stale regions
+ */
+static int stale_posted(void)
+{
+    if (damage_get_mode() == DAMAGE_MODE_TILES)
+        return tilemap_count(&stale_tiles) != 0;
+    return stale_damage.count != 0 || stale_damage.full;
+}
+
+/**
+ * Move the stale regions into the pending damage
+ */
+static void take_stale(void)
+{
+    int i;
+
+    if (damage_get_mode() == DAMAGE_MODE_TILES) {
+        tilemap_or(&pending_tiles, &stale_tiles);
+        tilemap_clear(&stale_tiles);
+        return;
+    }
+
+    if (stale_damage.full)
+        damage_list_add_full(&pending_damage);
+    for (i = 0; i < stale_damage.count; i++) {
+        const DamageRect *r = &stale_damage.rects[i];
+        damage_list_add(&pending_damage, r->x, r->y, r->w, r->h);
+    }
+    damage_list_clear(&stale_damage);
+}
 
-    // Draw all plants (iterate all cells, but only draw if plant exists)
-    for (i = 0; i < GRID_ROWS; i++) {
-        for (j = 0; j < GRID_COLS; j++) {
-            int cell_x = GRID_START_X + j * GRID_WIDTH;
-            int cell_y = GRID_START_Y + i * GRID_HEIGHT;
+/**
+ * Post damage for everything that changed since the previous call
+ * The current display list is diffed against the last one: a sprite
+ * whose id, frame or position changed posts its old and new bounds,
+ * one that did not change posts nothing. Bank changes are posted by
+ * plate_update. Returns nonzero if anything needs redrawing.
+ */
+int game_damage_changes(GameState *game)
+{
+    plate_update(game);
 
-            // Restore background for this cell
-            restore_background_rect(framebuf, cell_x, cell_y, GRID_WIDTH, GRID_HEIGHT);
+    game_build_display_list(game, &frame_list);
+    index_frame_list(game);
+    displist_diff(&shown_list, &frame_list, game_post_damage);
+    shown_list = frame_list;
 
-            // Draw plant if exists
-            if (game->grid[i][j].plant != PLANT_NONE) {
-                int plant_x = cell_x + (GRID_WIDTH - PLANT_SIZE) / 2;
-                int plant_y = cell_y + (GRID_HEIGHT - PLANT_SIZE) / 2;
-                
-                const u8 *sheet_data = (game->grid[i][j].plant == PLANT_SUNFLOWER) ?
-                                       gImage_SunFlower_ani : gImage_PeaShooter_ani;
+    if (damage_get_mode() == DAMAGE_MODE_TILES)
+        return tilemap_count(&pending_tiles) != 0;
+    return pending_damage.count != 0 || pending_damage.full;
+}
 
-                draw_sprite_from_sheet(framebuf, plant_x, plant_y, PLANT_SIZE, PLANT_SIZE,
-                                      sheet_data, game->grid[i][j].animation_frame);
-            }
-        }
+/**
+ * Redraw everything posted since the last call, then clear the pending damage
+ * Frame cost is bounded by damaged area, not by entity count squared.
+ * Draws the display list game_damage_changes built for this frame.
+ */
+void game_draw_damage(GameState *game, u8 *framebuf)
+{
+    int banded, recorded = 0;
+
+    // Sun count or card selection changed: rebuild that bank, post its area
+    plate_update(game);
+
+    // Stale regions are composed too, but only the frame's own changes
+    // enter the damage history, so they are recorded before merging
+    if (stale_posted()) {
+        record_pending();
+        take_stale();
+        recorded = 1;
     }
 
+    if (damage_get_mode() != DAMAGE_MODE_TILES)
+        damage_coalesce(&pending_damage);
+
+    // Both cores share the work when the other core is helping; the
+    // record is not safe to update from two cores, so it is made first
+    banded = bands_enabled() && pending_area() >= BANDS_MIN_AREA;
+    if (banded && !recorded) {
+        record_pending();
+        recorded = 1;
+    }
+
+    damage_pause(recorded);
+    if (banded)
+        compose_banded(framebuf);
+    else
+        compose_pending(framebuf, 0, SCREEN_HEIGHT);
+    damage_pause(0);
+
+    damage_list_clear(&pending_damage);
+    tilemap_clear(&pending_tiles);
+}
+
+/**
+ * FULL REDRAW: Draw complete game state (background, plants, entities, UI)
+ * Called when: initial draw, planting, or UI state changes
+ */
+void game_draw_full(GameState *game, u8 *framebuf)
+{
+    // Compose the whole screen in one pass
+    damage_list_clear(&pending_damage);
+    damage_list_add_full(&pending_damage);
+    tilemap_mark_all(&pending_tiles);
+    game_build_display_list(game, &frame_list);
+    index_frame_list(game);
+    game_draw_damage(game, framebuf);
+
+    // Everything is now drawn as listed: the next diff starts from here
+    shown_list = frame_list;
+
     // Update tracking variables
     game->prev_sun_count = game->sun_count;
     game->prev_selected_card = game->selected_card;
 }
 
+/**
+ * Put a plant in a cell (or clear it with PLANT_NONE), keeping the
+ * occupancy masks in step with the grid
+ */
+void game_set_plant(GameState *game, int row, int col, PlantType type)
+{
+    u16 bit = 1u << col;
+
+    game->plant_type_cols[game->grid[row][col].plant][row] &= ~bit;
+    game->grid[row][col].plant = type;
+    if (type != PLANT_NONE) {
+        game->plant_type_cols[type][row] |= bit;
+        game->plant_cols[row] |= bit;
+        SGRID_PLACE(&game->sprites, SPRITE_ID_PLANT(row, col),
+                    PLANT_DRAW_X(col), PLANT_DRAW_Y(row), PLANT_SIZE, PLANT_SIZE);
+    } else {
+        game->plant_cols[row] &= ~bit;
+        SGRID_REMOVE(&game->sprites, SPRITE_ID_PLANT(row, col));
+    }
+}
+
 /**
  * Handle touch input
  */
@@ -699,7 +1568,7 @@ void game_handle_touch(GameState *game, int x, int y)
             int plant_x = GRID_START_X + grid_col * GRID_WIDTH + (GRID_WIDTH - PLANT_SIZE) / 2;
             int plant_y = GRID_START_Y + grid_row * GRID_HEIGHT + (GRID_HEIGHT - PLANT_SIZE) / 2;
 
-            game->grid[grid_row][grid_col].plant = game->cards[game->selected_card].type;
+            game_set_plant(game, grid_row, grid_col, game->cards[game->selected_card].type);
             game->sun_count -= game->cards[game->selected_card].cost;
             
             game->cards[game->selected_card].selected = 0;
@@ -715,17 +1584,29 @@ void game_handle_touch(GameState *game, int x, int y)
 
 /**
  * Helper: Draw a single plant cell (for when sun erases a plant)
+ * clip limits the repair to the erased part of the cell (NULL = whole cell)
  */
-void draw_single_plant_cell(GameState *game, u8 *framebuf, int row, int col)
+void draw_single_plant_cell(GameState *game, u8 *framebuf, int row, int col,
+                            const ClipRegion *clip)
 {
     if (row < 0 || row >= GRID_ROWS || col < 0 || col >= GRID_COLS)
         return;
 
     int cell_x = GRID_START_X + col * GRID_WIDTH;
     int cell_y = GRID_START_Y + row * GRID_HEIGHT;
+    const u8 *tile;
+
+    // Prebaked cell: background and plant in one copy
+    if (game->grid[row][col].plant != PLANT_NONE) {
+        tile = plant_cell_tile(row, col, game->grid[row][col].plant, game->grid[row][col].animation_frame);
+        if (tile) {
+            draw_sprite(framebuf, cell_x, cell_y, tile, GRID_WIDTH, GRID_HEIGHT, clip);
+            return;
+        }
+    }
 
     // Restore background
-    restore_background_rect(framebuf, cell_x, cell_y, GRID_WIDTH, GRID_HEIGHT);
+    restore_background_rect(framebuf, cell_x, cell_y, GRID_WIDTH, GRID_HEIGHT, clip);
 
     // Draw plant if exists
     if (game->grid[row][col].plant != PLANT_NONE) {
@@ -736,7 +1617,7 @@ void draw_single_plant_cell(GameState *game, u8 *framebuf, int row, int col)
                                gImage_SunFlower_ani : gImage_PeaShooter_ani;
 
         draw_sprite_from_sheet(framebuf, plant_x, plant_y, PLANT_SIZE, PLANT_SIZE,
-                              sheet_data, game->grid[row][col].animation_frame);
+                              sheet_data, game->grid[row][col].animation_frame, clip);
     }
 }
 
@@ -745,28 +1626,25 @@ void draw_single_plant_cell(GameState *game, u8 *framebuf, int row, int col)
  */
 void game_spawn_sun(GameState *game, int source_x, int source_y)
 {
-    int i;
+    // Take a free sun slot; nothing spawns while every slot is in use
+    int i = POOL_ALLOC(&game->sun_pool);
 
-    // Find an inactive sun slot
-    for (i = 0; i < MAX_SUNS; i++) {
-        if (!game->suns[i].active) {
-            game->suns[i].active = 1;
-            game->suns[i].landed = 0;  // Start flying
-            game->suns[i].x = (float)source_x;
-            game->suns[i].y = (float)source_y;
-            game->suns[i].prev_x = source_x;
-            game->suns[i].prev_y = source_y;
-
-            // Physics: arc to the right
-            game->suns[i].vx = SUN_INITIAL_VX;
-            game->suns[i].vy = SUN_INITIAL_VY;
-            game->suns[i].lifetime = SUN_LIFETIME;
-
-            game->num_active_suns++;
-            printf("Sun spawned at (%d, %d), active suns: %d\n", source_x, source_y, game->num_active_suns);
-            break;
-        }
-    }
+    if (i < 0)
+        return;
+
+    game->suns[i].landed = 0;  // Start flying
+    game->suns[i].x = (float)source_x;
+    game->suns[i].y = (float)source_y;
+    game->suns[i].tick_x = game->suns[i].x;
+    game->suns[i].tick_y = game->suns[i].y;
+
+    // Physics: arc to the right
+    game->suns[i].vx = SUN_INITIAL_VX;
+    game->suns[i].vy = SUN_INITIAL_VY;
+    game->suns[i].lifetime = SUN_LIFETIME;
+    sun_place(game, i);
+
+    printf("Sun spawned at (%d, %d), active suns: %d\n", source_x, source_y, game->sun_pool.count);
 }
 
 /**
@@ -775,62 +1653,59 @@ void game_spawn_sun(GameState *game, int source_x, int source_y)
  */
 void game_update_suns(GameState *game)
 {
-    int i, row, col;
-
-    // Update existing suns (physics simulation)
-    for (i = 0; i < MAX_SUNS; i++) {
-        if (game->suns[i].active) {
-            // Store previous position for dirty rect
-//            game->suns[i].prev_x = (int)game->suns[i].x;
-//            game->suns[i].prev_y = (int)game->suns[i].y;
-
-            // Only apply physics if sun hasn't landed yet
-            if (!game->suns[i].landed) {
-                // Apply gravity
-                game->suns[i].vy += SUN_GRAVITY;
-
-                // Update position
-                game->suns[i].x += game->suns[i].vx;
-                game->suns[i].y += game->suns[i].vy;
-
-                // Check if sun has reached landing height
-                if (game->suns[i].y >= SUN_LANDING_HEIGHT) {
-                    game->suns[i].y = (float)SUN_LANDING_HEIGHT;
-                    game->suns[i].vx = 0.0f;
-                    game->suns[i].vy = 0.0f;
-                    game->suns[i].landed = 1;
-                    printf("Sun %d landed at height %d\n", i, SUN_LANDING_HEIGHT);
-                }
+    int n, i, row, col;
+    u16 bits;
+
+    // Update existing suns (physics simulation); backwards so expiring
+    // suns can be freed on the way
+    for (n = game->sun_pool.count - 1; n >= 0; n--) {
+        i = game->sun_pool.live[n];
+
+        // Only apply physics if sun hasn't landed yet
+        if (!game->suns[i].landed) {
+            // Apply gravity
+            game->suns[i].vy += SUN_GRAVITY;
+
+            // Update position
+            game->suns[i].x += game->suns[i].vx;
+            game->suns[i].y += game->suns[i].vy;
+
+            // Check if sun has reached landing height
+            if (game->suns[i].y >= SUN_LANDING_HEIGHT) {
+                game->suns[i].y = (float)SUN_LANDING_HEIGHT;
+                game->suns[i].vx = 0.0f;
+                game->suns[i].vy = 0.0f;
+                game->suns[i].landed = 1;
+                printf("Sun %d landed at height %d\n", i, SUN_LANDING_HEIGHT);
             }
+        }
+        sun_place(game, i);
 
-            // Decrease lifetime (for both flying and landed suns)
-            game->suns[i].lifetime--;
-            if (game->suns[i].lifetime <= 0) {
-                game->suns[i].active = 0;
-                game->num_active_suns--;
-                printf("Sun %d expired, active suns: %d\n", i, game->num_active_suns);
-            }
+        // Decrease lifetime (for both flying and landed suns)
+        game->suns[i].lifetime--;
+        if (game->suns[i].lifetime <= 0) {
+            sun_free(game, i);
+            printf("Sun %d expired, active suns: %d\n", i, game->sun_pool.count);
         }
     }
 
     // Check sunflowers for sun production
     for (row = 0; row < GRID_ROWS; row++) {
-        for (col = 0; col < GRID_COLS; col++) {
-            if (game->grid[row][col].plant == PLANT_SUNFLOWER) {
-                game->grid[row][col].sun_spawn_counter++;
+        for (bits = game->plant_type_cols[PLANT_SUNFLOWER][row]; bits; bits &= bits - 1) {
+            col = __builtin_ctz(bits);
+            game->grid[row][col].sun_spawn_counter++;
 
-                // Spawn sun every SUN_SPAWN_INTERVAL ticks (25 seconds)
-                if (game->grid[row][col].sun_spawn_counter >= SUN_SPAWN_INTERVAL) {
-                    game->grid[row][col].sun_spawn_counter = 0;
+            // Spawn sun every SUN_SPAWN_INTERVAL ticks (25 seconds)
+            if (game->grid[row][col].sun_spawn_counter >= SUN_SPAWN_INTERVAL) {
+                game->grid[row][col].sun_spawn_counter = 0;
 
-                    // Spawn sun above the sunflower
-                    int cell_x = GRID_START_X + col * GRID_WIDTH;
-                    int cell_y = GRID_START_Y + row * GRID_HEIGHT;
-                    int spawn_x = cell_x + GRID_WIDTH / 2 - SUN_SIZE / 2;
-                    int spawn_y = cell_y - SUN_SIZE;  // Above the plant
+                // Spawn sun above the sunflower
+                int cell_x = GRID_START_X + col * GRID_WIDTH;
+                int cell_y = GRID_START_Y + row * GRID_HEIGHT;
+                int spawn_x = cell_x + GRID_WIDTH / 2 - SUN_SIZE / 2;
+                int spawn_y = cell_y - SUN_SIZE;  // Above the plant
 
-                    game_spawn_sun(game, spawn_x, spawn_y);
-                }
+                game_spawn_sun(game, spawn_x, spawn_y);
             }
         }
     }
@@ -842,126 +1717,28 @@ void game_update_suns(GameState *game)
  */
 int game_check_sun_click(GameState *game, int x, int y)
 {
-    int i;
-
-    for (i = 0; i < MAX_SUNS; i++) {
-        if (game->suns[i].active) {
-            int sun_x = (int)game->suns[i].x;
-            int sun_y = (int)game->suns[i].y;
-
-            // Check if click is within sun bounds
-            if (x >= sun_x && x < sun_x + SUN_SIZE &&
-                y >= sun_y && y < sun_y + SUN_SIZE) {
-
-                // Collect sun
-                game->sun_count += SUN_VALUE;
-                game->suns[i].active = 0;
-                game->num_active_suns--;
-
-                printf("Sun collected! Total sun: %d\n", game->sun_count);
-                return 1;
-            }
-        }
-    }
-
-    return 0;
-}
-
-/**
- * OPTIMIZED: Draw suns with dirty rectangle optimization
- * Uses two-phase approach: erase all, then draw all
- * This prevents suns from erasing each other
- */
-void game_draw_suns(GameState *game, u8 *framebuf)
-{
-    int i, j, row, col;
-    extern const unsigned char gImage_Sun[];
+    int n, i;
 
-    // --- PHASE 1: ERASE ALL OLD POSITIONS ---
-    for (i = 0; i < MAX_SUNS; i++) {
-        int prev_x = game->suns[i].prev_x;
-        int prev_y = game->suns[i].prev_y;
-        int need_erase = 0;
+    for (n = 0; n < game->sun_pool.count; n++) {
+        i = game->sun_pool.live[n];
 
-        // Determine if we need to erase:
-        // 1. Sun is active (active=1): need to erase previous position
-        // 2. Sun just died (active=0 but prev_x!=-1): need to erase last frame
-        if (game->suns[i].active) {
-            need_erase = 1;
-        } else if (prev_x != -1) {
-            need_erase = 1;
-        }
+        int sun_x = (int)game->suns[i].x;
+        int sun_y = (int)game->suns[i].y;
 
-        if (need_erase) {
-            int erase_x = prev_x - SUN_ERASE_MARGIN;
-            int erase_y = prev_y - SUN_ERASE_MARGIN;
-            int erase_w = SUN_SIZE + (SUN_ERASE_MARGIN * 2);
-            int erase_h = SUN_SIZE + (SUN_ERASE_MARGIN * 2);
-
-            // Boundary check
-            if (erase_x < 0) { erase_w += erase_x; erase_x = 0; }
-            if (erase_y < 0) { erase_h += erase_y; erase_y = 0; }
-            if (erase_x + erase_w > SCREEN_WIDTH) erase_w = SCREEN_WIDTH - erase_x;
-            if (erase_y + erase_h > SCREEN_HEIGHT) erase_h = SCREEN_HEIGHT - erase_y;
-
-            // 1. Restore background (SAFE - avoids UI areas)
-            restore_background_rect_safe(framebuf, erase_x, erase_y, erase_w, erase_h);
-
-            // 2. Redraw UI elements if they were in the erase area (CRITICAL!)
-            redraw_ui_if_overlapped(game, framebuf, erase_x, erase_y, erase_w, erase_h);
-
-            // 3. Redraw plants that were covered
-            for (row = 0; row < GRID_ROWS; row++) {
-                for (col = 0; col < GRID_COLS; col++) {
-                    if (game->grid[row][col].plant != PLANT_NONE) {
-                        int cell_x = GRID_START_X + col * GRID_WIDTH;
-                        int cell_y = GRID_START_Y + row * GRID_HEIGHT;
-
-                        if (rects_overlap(erase_x, erase_y, erase_w, erase_h,
-                                        cell_x, cell_y, GRID_WIDTH, GRID_HEIGHT)) {
-                            draw_single_plant_cell(game, framebuf, row, col);
-                        }
-                    }
-                }
-            }
+        // Check if click is within sun bounds
+        if (x >= sun_x && x < sun_x + SUN_SIZE &&
+            y >= sun_y && y < sun_y + SUN_SIZE) {
 
-            // 4. Redraw zombies that were covered
-            for (j = 0; j < MAX_ZOMBIES; j++) {
-                if (game->zombies[j].active) {
-                    int zombie_x = (int)game->zombies[j].x;
-                    int zombie_y = (int)game->zombies[j].y + ZOMBIE_Y_OFFSET;
+            // Collect sun
+            game->sun_count += SUN_VALUE;
+            sun_free(game, i);
 
-                    if (rects_overlap(erase_x, erase_y, erase_w, erase_h,
-                                    zombie_x, zombie_y, ZOMBIE_DISPLAY_WIDTH, ZOMBIE_DISPLAY_HEIGHT)) {
-                        draw_zombie_sprite(framebuf, (int)game->zombies[j].x, (int)game->zombies[j].y,
-                                         gImage_walk_ani, game->zombies[j].animation_frame);
-                    }
-                }
-            }
+            printf("Sun collected! Total sun: %d\n", game->sun_count);
+            return 1;
         }
     }
 
-    // --- PHASE 2: DRAW ALL NEW SUN POSITIONS ---
-    for (i = 0; i < MAX_SUNS; i++) {
-        if (game->suns[i].active) {
-            int curr_x = (int)game->suns[i].x;
-            int curr_y = (int)game->suns[i].y;
-
-            if (curr_x >= 0 && curr_y >= 0 &&
-                curr_x + SUN_SIZE <= SCREEN_WIDTH &&
-                curr_y + SUN_SIZE <= SCREEN_HEIGHT) {
-                draw_sprite_transparent(framebuf, curr_x, curr_y, gImage_Sun, SUN_SIZE, SUN_SIZE);
-            }
-
-            // Update position tracking
-            game->suns[i].prev_x = curr_x;
-            game->suns[i].prev_y = curr_y;
-        }
-        else {
-            // Sun died and erased, set position to -1 to avoid re-erase
-            game->suns[i].prev_x = -1;
-        }
-    }
+    return 0;
 }
 
 /* ============================================================ */
@@ -973,43 +1750,38 @@ void game_draw_suns(GameState *game, u8 *framebuf)
  */
 void game_spawn_zombie(GameState *game)
 {
-    int i;
+    // Take a free zombie slot; nothing spawns while every slot is in use
+    int i = POOL_ALLOC(&game->zombie_pool);
 
-    // Find an inactive zombie slot
-    for (i = 0; i < MAX_ZOMBIES; i++) {
-        if (!game->zombies[i].active) {
-            // Spawn zombie
-            game->zombies[i].active = 1;
-            game->zombies[i].x = (float)ZOMBIE_SPAWN_X;
-
-            // Random row (0-4)
-            game->zombies[i].row = rand() % GRID_ROWS;
+    if (i < 0)
+        return;
 
-            // Calculate Y position based on row
-            game->zombies[i].y = (float)(GRID_START_Y + game->zombies[i].row * GRID_HEIGHT);
+    game->zombies[i].x = (float)ZOMBIE_SPAWN_X;
 
-            // Initialize position tracking
-            game->zombies[i].prev_x = ZOMBIE_SPAWN_X;
-            game->zombies[i].prev_y = (int)game->zombies[i].y;
+    // Random row (0-4)
+    game->zombies[i].row = rand() % GRID_ROWS;
 
-            // Start at random animation frame for variety
-            game->zombies[i].animation_frame = rand() % (ZOMBIE_ROWS * ZOMBIE_COLS);
+    // Calculate Y position based on row
+    game->zombies[i].y = (float)(GRID_START_Y + game->zombies[i].row * GRID_HEIGHT);
+    game->zombies[i].tick_x = game->zombies[i].x;
+    game->zombies[i].tick_y = game->zombies[i].y;
 
-            // Initialize health
-            game->zombies[i].health = ZOMBIE_MAX_HEALTH;
+    // Start at random animation frame for variety
+    game->zombies[i].animation_frame = rand() % (ZOMBIE_ROWS * ZOMBIE_COLS);
 
-            // Initialize biting state
-            game->zombies[i].state = ZOMBIE_WALKING;
-            game->zombies[i].target_col = -1;
-            game->zombies[i].bite_timer = 0;
-            game->zombies[i].bite_anim_frame = 0;
+    // Initialize health
+    game->zombies[i].health = ZOMBIE_MAX_HEALTH;
 
-            game->num_active_zombies++;
+    // Initialize biting state
+    game->zombies[i].state = ZOMBIE_WALKING;
+    game->zombies[i].target_col = -1;
+    game->zombies[i].bite_timer = 0;
+    game->zombies[i].bite_anim_frame = 0;
+    lane_insert(game->lanes.zombies[game->zombies[i].row], &game->lanes.zombie_count[game->zombies[i].row],
+                &game->zombies[0].x, sizeof(Zombie), i);
+    zombie_place(game, i);
 
-            printf("Zombie spawned at row %d with %d health\n", game->zombies[i].row, game->zombies[i].health);
-            break;
-        }
-    }
+    printf("Zombie spawned at row %d with %d health\n", game->zombies[i].row, game->zombies[i].health);
 }
 
 /**
@@ -1021,7 +1793,7 @@ void game_spawn_zombie(GameState *game)
  */
 void game_update_zombies(GameState *game)
 {
-    int i, col, row;
+    int n, i, col, row;
 
     // Check for game over condition (zombie breached left boundary)
     if (game_check_defeat(game)) {
@@ -1036,8 +1808,9 @@ void game_update_zombies(GameState *game)
             game->bite_animation_counter = 0;
 
             // Update bite animations for zombies at the boundary
-            for (i = 0; i < MAX_ZOMBIES; i++) {
-                if (game->zombies[i].active && game->zombies[i].state == ZOMBIE_BITING) {
+            for (n = 0; n < game->zombie_pool.count; n++) {
+                i = game->zombie_pool.live[n];
+                if (game->zombies[i].state == ZOMBIE_BITING) {
                     game->zombies[i].bite_anim_frame++;
                     if (game->zombies[i].bite_anim_frame >= BITE_ANIMATION_FRAMES) {
                         game->zombies[i].bite_anim_frame = 0;
@@ -1072,16 +1845,24 @@ void game_update_zombies(GameState *game)
         update_bite_anim = 1;
     }
 
-    // Process each zombie
-    for (i = 0; i < MAX_ZOMBIES; i++) {
-        if (!game->zombies[i].active) continue;
+    // Move walking zombies left, then put each lane back in x order
+    for (n = 0; n < game->zombie_pool.count; n++) {
+        i = game->zombie_pool.live[n];
+        if (game->zombies[i].state == ZOMBIE_WALKING)
+            game->zombies[i].x -= ZOMBIE_SPEED;
+    }
+    for (row = 0; row < GRID_ROWS; row++)
+        lane_sort(game->lanes.zombies[row], game->lanes.zombie_count[row], &game->zombies[0].x, sizeof(Zombie));
+
+    // Process each zombie; backwards so zombies leaving the screen can be
+    // freed on the way
+    for (n = game->zombie_pool.count - 1; n >= 0; n--) {
+        i = game->zombie_pool.live[n];
+        zombie_place(game, i);
 
         if (game->zombies[i].state == ZOMBIE_WALKING) {
             // === WALKING STATE ===
 
-            // Move left
-            game->zombies[i].x -= ZOMBIE_SPEED;
-
             // Update walking animation
             if (update_walk_anim) {
                 game->zombies[i].animation_frame++;
@@ -1092,8 +1873,7 @@ void game_update_zombies(GameState *game)
 
             // Check if zombie went off screen
             if (game->zombies[i].x + ZOMBIE_DISPLAY_WIDTH < 0) {
-                game->zombies[i].active = 0;
-                game->num_active_zombies--;
+                zombie_free(game, i);
                 printf("Zombie left screen\n");
                 continue;
             }
@@ -1103,27 +1883,27 @@ void game_update_zombies(GameState *game)
             int zombie_center_x = (int)game->zombies[i].x + (ZOMBIE_DISPLAY_WIDTH / 2);
             int zombie_row = game->zombies[i].row;
 
-            // Check each column for plants
-            for (col = 0; col < GRID_COLS; col++) {
-                if (game->grid[zombie_row][col].plant != PLANT_NONE) {
-                    // Calculate plant position
-                    int plant_x = GRID_START_X + col * GRID_WIDTH;
-                    int plant_right = plant_x + PLANT_SIZE;
-
-                    // Check if zombie center is touching plant's right side
-                    // (approaching from the right, zombie center passes plant edge)
-                    if (zombie_center_x <= plant_right &&
-                        zombie_center_x >= plant_x) {
-                        // Collision! Start biting
-                        game->zombies[i].state = ZOMBIE_BITING;
-                        game->zombies[i].target_col = col;
-                        game->zombies[i].bite_timer = BITE_DURATION;
-                        game->zombies[i].bite_anim_frame = 0;
-
-                        printf("Zombie %d started biting plant at row %d, col %d\n",
-                               i, zombie_row, col);
-                        break;  // Stop checking columns
-                    }
+            // Plants are narrower than their cells, so only the cell under
+            // the zombie center can hold a plant it touches
+            if (zombie_center_x < GRID_START_X)
+                continue;
+            col = (zombie_center_x - GRID_START_X) / GRID_WIDTH;
+            if ((game->plant_cols[zombie_row] >> col) & 1) {
+                // Calculate plant position
+                int plant_x = GRID_START_X + col * GRID_WIDTH;
+                int plant_right = plant_x + PLANT_SIZE;
+
+                // Check if zombie center is touching plant's right side
+                // (approaching from the right, zombie center passes plant edge)
+                if (zombie_center_x <= plant_right) {
+                    // Collision! Start biting
+                    game->zombies[i].state = ZOMBIE_BITING;
+                    game->zombies[i].target_col = col;
+                    game->zombies[i].bite_timer = BITE_DURATION;
+                    game->zombies[i].bite_anim_frame = 0;
+
+                    printf("Zombie %d started biting plant at row %d, col %d\n",
+                           i, zombie_row, col);
                 }
             }
         }
@@ -1151,7 +1931,7 @@ void game_update_zombies(GameState *game)
 
                 if (target_col >= 0 && target_col < GRID_COLS) {
                     PlantType killed_plant = game->grid[target_row][target_col].plant;
-                    game->grid[target_row][target_col].plant = PLANT_NONE;
+                    game_set_plant(game, target_row, target_col, PLANT_NONE);
                     game->grid[target_row][target_col].animation_frame = 0;
                     game->grid[target_row][target_col].sun_spawn_counter = 0;
                     game->grid[target_row][target_col].shoot_counter = 0;
@@ -1161,11 +1941,11 @@ void game_update_zombies(GameState *game)
 
                     // Check if any OTHER zombies are also biting this plant
                     // If so, they should resume walking too
-                    int j;
-                    for (j = 0; j < MAX_ZOMBIES; j++) {
-                        if (j != i && game->zombies[j].active &&
+                    int m, j;
+                    for (m = 0; m < game->lanes.zombie_count[target_row]; m++) {
+                        j = game->lanes.zombies[target_row][m];
+                        if (j != i &&
                             game->zombies[j].state == ZOMBIE_BITING &&
-                            game->zombies[j].row == target_row &&
                             game->zombies[j].target_col == target_col) {
                             // This zombie was also biting the same plant
                             game->zombies[j].state = ZOMBIE_WALKING;
@@ -1190,7 +1970,7 @@ void game_update_zombies(GameState *game)
                 int target_col = game->zombies[i].target_col;
 
                 if (target_col >= 0 && target_col < GRID_COLS) {
-                    if (game->grid[target_row][target_col].plant == PLANT_NONE) {
+                    if (!((game->plant_cols[target_row] >> target_col) & 1)) {
                         // Plant was destroyed (probably by peas) - resume walking
                         game->zombies[i].state = ZOMBIE_WALKING;
                         game->zombies[i].target_col = -1;
@@ -1205,17 +1985,85 @@ void game_update_zombies(GameState *game)
     }
 }
 
+/**
+ * Nearest zombie in a lane whose left edge is at or right of x
+ * Binary search of the lane's sorted zombie list; returns the zombie's
+ * slot, or -1 when there is none.
+ */
+int game_nearest_zombie_right(const GameState *game, int row, float x)
+{
+    const u16 *list = game->lanes.zombies[row];
+    int lo = 0, hi = game->lanes.zombie_count[row];
+
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+
+        if (game->zombies[list[mid]].x < x)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return (lo < game->lanes.zombie_count[row]) ? list[lo] : -1;
+}
+
+/**
+ * Draw a zombie frame straight from its sprite sheet, scaling per pixel
+ * Fallback when no pre-scaled frame is cached. The frame is frame_w x frame_h
+ * at (src_x, src_y) in a sheet_w wide sheet; black is transparent.
+ */
+static void blit_zombie_sheet(u8 *framebuf, const ClipSpans *spans, int dst_x, int dst_y,
+                              const u8 *sheet_data, int sheet_w, int src_x, int src_y,
+                              int frame_w, int frame_h)
+{
+    int b, s, py, px;
+    // Inverse scaling by ZOMBIE_SCALE; one table serves both axes (same ratio)
+    const ScaleTable *zoom = scale_table_get(100, ZOMBIE_SCALE_PERCENT, ZOMBIE_DISPLAY_HEIGHT);
+
+    for (b = 0; b < spans->num_bands; b++) {
+        const ClipBand *band = &spans->bands[b];
+
+        for (py = band->y0; py < band->y1; py++) {
+            // Calculate source row (inverse scaling)
+            int src_i = zoom->index[py - dst_y];
+            if (src_i >= frame_h)
+                src_i = frame_h - 1;
+
+            const u8 *src_row = sheet_data + ((src_y + src_i) * sheet_w + src_x) * 3;
+
+            for (s = 0; s < band->num_spans; s++) {
+                u8 *dst = framebuf + (py * SCREEN_WIDTH + band->spans[s].x0) * 3;
+
+                for (px = band->spans[s].x0; px < band->spans[s].x1; px++, dst += 3) {
+                    // Calculate source column (inverse scaling)
+                    int src_j = zoom->index[px - dst_x];
+                    if (src_j >= frame_w)
+                        src_j = frame_w - 1;
+
+                    const u8 *src = src_row + src_j * 3;
+
+                    // Check for BLACK background (0, 0, 0) - skip transparent pixels
+                    if (src[0] == 0 && src[1] == 0 && src[2] == 0)
+                        continue;
+
+                    dst[0] = src[0];
+                    dst[1] = src[1];
+                    dst[2] = src[2];
+                }
+            }
+        }
+    }
+}
+
 /**
  * Draw zombie sprite from sprite sheet with scaling and black transparency
  * CRITICAL: Does NOT draw in UI protected areas
  */
 void draw_zombie_sprite(u8 *framebuf, int dst_x, int dst_y,
-                       const u8 *sheet_data, int frame_index)
+                       const u8 *sheet_data, int frame_index, const ClipRegion *clip)
 {
-    int row, col, i, j;
-    int src_x, src_y;
-    u32 fb_idx, sheet_idx;
-    float scale = ZOMBIE_SCALE;
+    ClipRegion region;
+    ClipSpans spans;
 
     // Apply Y offset for better visual positioning
     dst_y += ZOMBIE_Y_OFFSET;
@@ -1226,70 +2074,31 @@ void draw_zombie_sprite(u8 *framebuf, int dst_x, int dst_y,
         return;
     }
 
-    // Calculate source position in sprite sheet
-    row = frame_index / ZOMBIE_COLS;
-    col = frame_index % ZOMBIE_COLS;
-    src_x = col * ZOMBIE_WIDTH;
-    src_y = row * ZOMBIE_HEIGHT;
-
-    // Pre-calculate UI boundaries for fast checking
-    int seedbank_right = UI_SEEDBANK_X + UI_SEEDBANK_WIDTH;
-    int seedbank_bottom = UI_SEEDBANK_Y + UI_SEEDBANK_HEIGHT;
-    int sunbank_right = UI_SUNBANK_X + UI_SUNBANK_WIDTH;
-    int sunbank_bottom = UI_SUNBANK_Y + UI_SUNBANK_HEIGHT;
-
-    // Draw with scaling and transparency (black background = transparent)
-    for (i = 0; i < ZOMBIE_DISPLAY_HEIGHT; i++) {
-        int pixel_y = dst_y + i;
-
-        // Skip if row is outside screen
-        if (pixel_y < 0 || pixel_y >= SCREEN_HEIGHT)
-            continue;
-
-        // Calculate source row (inverse scaling)
-        int src_i = (int)(i / scale);
-        if (src_i >= ZOMBIE_HEIGHT)
-            src_i = ZOMBIE_HEIGHT - 1;
-
-        for (j = 0; j < ZOMBIE_DISPLAY_WIDTH; j++) {
-            int pixel_x = dst_x + j;
-
-            // Skip if column is outside screen
-            if (pixel_x < 0 || pixel_x >= SCREEN_WIDTH)
-                continue;
-
-            // CRITICAL: Skip if pixel is in UI protected area
-            // Check seedbank
-            if (pixel_x >= UI_SEEDBANK_X && pixel_x < seedbank_right &&
-                pixel_y >= UI_SEEDBANK_Y && pixel_y < seedbank_bottom) {
-                continue;  // Don't draw on seedbank!
-            }
-            // Check sunbank
-            if (pixel_x >= UI_SUNBANK_X && pixel_x < sunbank_right &&
-                pixel_y >= UI_SUNBANK_Y && pixel_y < sunbank_bottom) {
-                continue;  // Don't draw on sunbank!
-            }
-
-            // Calculate source column (inverse scaling)
-            int src_j = (int)(j / scale);
-            if (src_j >= ZOMBIE_WIDTH)
-                src_j = ZOMBIE_WIDTH - 1;
+    // The UI banks are cut out once here instead of tested per pixel
+    clip_region_protect_ui(&region, clip);
+    if (!clip_build_spans(&region, dst_x, dst_y, ZOMBIE_DISPLAY_WIDTH, ZOMBIE_DISPLAY_HEIGHT, &spans))
+        return;
 
-            sheet_idx = ((src_y + src_i) * ZOMBIE_SHEET_WIDTH + (src_x + src_j)) * 3;
+    damage_add_spans(&spans);
 
-            // Check for BLACK background (0, 0, 0) - skip transparent pixels
-            if (sheet_data[sheet_idx] == 0 &&
-                sheet_data[sheet_idx + 1] == 0 &&
-                sheet_data[sheet_idx + 2] == 0) {
-                continue;
-            }
+    // Encoded frame: run copies only
+    const RleSprite *rle = sprite_cache_walk_rle(frame_index);
+    if (rle) {
+        rle_blit(framebuf, dst_x, dst_y, rle, &spans);
+        return;
+    }
 
-            fb_idx = (pixel_y * SCREEN_WIDTH + pixel_x) * 3;
-            framebuf[fb_idx]     = sheet_data[sheet_idx];
-            framebuf[fb_idx + 1] = sheet_data[sheet_idx + 1];
-            framebuf[fb_idx + 2] = sheet_data[sheet_idx + 2];
-        }
+    // Pre-scaled frame available: no per-pixel scaling
+    const u8 *frame = sprite_cache_walk(frame_index);
+    if (frame) {
+        draw_rows(framebuf, &spans, dst_x, dst_y, frame, ZOMBIE_DISPLAY_WIDTH, ROW_KEY_BLACK);
+        return;
     }
+
+    blit_zombie_sheet(framebuf, &spans, dst_x, dst_y, sheet_data, ZOMBIE_SHEET_WIDTH,
+                      (frame_index % ZOMBIE_COLS) * ZOMBIE_WIDTH,
+                      (frame_index / ZOMBIE_COLS) * ZOMBIE_HEIGHT,
+                      ZOMBIE_WIDTH, ZOMBIE_HEIGHT);
 }
 
 
@@ -1299,206 +2108,47 @@ void draw_zombie_sprite(u8 *framebuf, int dst_x, int dst_y,
  * CRITICAL: Does NOT draw in UI protected areas
  */
 void draw_bite_sprite(u8 *framebuf, int dst_x, int dst_y,
-                      const u8 *sheet_data, int frame_index)
+                      const u8 *sheet_data, int frame_index, const ClipRegion *clip)
 {
-    int row, col, i, j;
-    int src_x, src_y;
-    u32 fb_idx, sheet_idx;
-    float scale = ZOMBIE_SCALE;
+    int row, col;
+    ClipRegion region;
+    ClipSpans spans;
 
     // Calculate source position in sprite sheet
     row = frame_index / BITE_COLS;
     col = frame_index % BITE_COLS;
-    src_x = col * BITE_FRAME_WIDTH;
-    src_y = row * BITE_FRAME_HEIGHT;
 
     // Boundary check for source
     if (row >= BITE_ROWS || col >= BITE_COLS)
         return;
 
-    // UI protection boundary calculations (done once)
-    int seedbank_right = UI_SEEDBANK_X + UI_SEEDBANK_WIDTH;
-    int seedbank_bottom = UI_SEEDBANK_Y + UI_SEEDBANK_HEIGHT;
-    int sunbank_right = UI_SUNBANK_X + UI_SUNBANK_WIDTH;
-    int sunbank_bottom = UI_SUNBANK_Y + UI_SUNBANK_HEIGHT;
-
     // Apply Y offset for proper positioning
     int display_y = dst_y + ZOMBIE_Y_OFFSET;
 
-    // Draw scaled sprite with transparency
-    for (i = 0; i < ZOMBIE_DISPLAY_HEIGHT; i++) {
-        for (j = 0; j < ZOMBIE_DISPLAY_WIDTH; j++) {
-            // Calculate destination pixel position
-            int pixel_x = dst_x + j;
-            int pixel_y = display_y + i;
-
-            // Skip if pixel is outside screen
-            if (pixel_x < 0 || pixel_x >= SCREEN_WIDTH ||
-                pixel_y < 0 || pixel_y >= SCREEN_HEIGHT)
-                continue;
-
-            // CRITICAL: Skip if pixel is in UI protected area
-            // Check seedbank
-            if (pixel_x >= UI_SEEDBANK_X && pixel_x < seedbank_right &&
-                pixel_y >= UI_SEEDBANK_Y && pixel_y < seedbank_bottom) {
-                continue;  // Don't draw on seedbank!
-            }
-            // Check sunbank
-            if (pixel_x >= UI_SUNBANK_X && pixel_x < sunbank_right &&
-                pixel_y >= UI_SUNBANK_Y && pixel_y < sunbank_bottom) {
-                continue;  // Don't draw on sunbank!
-            }
-
-            // Calculate source column (inverse scaling)
-            int src_j = (int)(j / scale);
-            if (src_j >= BITE_FRAME_WIDTH)
-                src_j = BITE_FRAME_WIDTH - 1;
-
-            // Calculate source row (inverse scaling)
-            int src_i = (int)(i / scale);
-            if (src_i >= BITE_FRAME_HEIGHT)
-                src_i = BITE_FRAME_HEIGHT - 1;
-
-            // Calculate sprite sheet index
-            sheet_idx = ((src_y + src_i) * BITE_SHEET_WIDTH + (src_x + src_j)) * 3;
+    // The UI banks are cut out once here instead of tested per pixel
+    clip_region_protect_ui(&region, clip);
+    if (!clip_build_spans(&region, dst_x, display_y, ZOMBIE_DISPLAY_WIDTH, ZOMBIE_DISPLAY_HEIGHT, &spans))
+        return;
 
-            // Check for BLACK background (0, 0, 0) - skip transparent pixels
-            if (sheet_data[sheet_idx] == 0 &&
-                sheet_data[sheet_idx + 1] == 0 &&
-                sheet_data[sheet_idx + 2] == 0) {
-                continue;
-            }
+    damage_add_spans(&spans);
 
-            // Draw pixel
-            fb_idx = (pixel_y * SCREEN_WIDTH + pixel_x) * 3;
-            framebuf[fb_idx]     = sheet_data[sheet_idx];
-            framebuf[fb_idx + 1] = sheet_data[sheet_idx + 1];
-            framebuf[fb_idx + 2] = sheet_data[sheet_idx + 2];
-        }
+    // Encoded frame: run copies only
+    const RleSprite *rle = sprite_cache_bite_rle(frame_index);
+    if (rle) {
+        rle_blit(framebuf, dst_x, display_y, rle, &spans);
+        return;
     }
-}
-
-/**
- * Draw all zombies with dirty rect optimization
- * Uses two-phase approach: erase all, then draw all
- */
-void game_draw_zombies(GameState *game, u8 *framebuf)
-{
-    int i, j, row, col;
-
-    // --- PHASE 1: ERASE ALL OLD POSITIONS ---
-    for (i = 0; i < MAX_ZOMBIES; i++) {
-        int prev_x = game->zombies[i].prev_x;
-        int prev_y = game->zombies[i].prev_y;
-        int need_erase = 0;
-
-        // Determine if we need to erase:
-        // 1. Zombie is active (active=1): need to erase previous position
-        // 2. Zombie just died (active=0 but prev_x!=-1): need to erase last frame
-        if (game->zombies[i].active) {
-            need_erase = 1;
-        } else if (prev_x != -1) {
-            need_erase = 1;
-        }
-
-        if (need_erase) {
-            // Account for Y offset and use display size
-            int erase_x = prev_x - ZOMBIE_ERASE_MARGIN;
-            int erase_y = (prev_y + ZOMBIE_Y_OFFSET) - ZOMBIE_ERASE_MARGIN;
-            int erase_w = ZOMBIE_DISPLAY_WIDTH + (ZOMBIE_ERASE_MARGIN * 2);
-            int erase_h = ZOMBIE_DISPLAY_HEIGHT + (ZOMBIE_ERASE_MARGIN * 2);
-
-            // Boundary check
-            if (erase_x < 0) { erase_w += erase_x; erase_x = 0; }
-            if (erase_y < 0) { erase_h += erase_y; erase_y = 0; }
-            if (erase_x + erase_w > SCREEN_WIDTH) erase_w = SCREEN_WIDTH - erase_x;
-            if (erase_y + erase_h > SCREEN_HEIGHT) erase_h = SCREEN_HEIGHT - erase_y;
-
-            // 1. Restore background (SAFE - avoids UI areas)
-            restore_background_rect_safe(framebuf, erase_x, erase_y, erase_w, erase_h);
-
-            // 2. Redraw UI elements if they were in the erase area (CRITICAL!)
-            redraw_ui_if_overlapped(game, framebuf, erase_x, erase_y, erase_w, erase_h);
-
-            // 3. Redraw plants that were covered
-            for (row = 0; row < GRID_ROWS; row++) {
-                for (col = 0; col < GRID_COLS; col++) {
-                    if (game->grid[row][col].plant != PLANT_NONE) {
-                        int cell_x = GRID_START_X + col * GRID_WIDTH;
-                        int cell_y = GRID_START_Y + row * GRID_HEIGHT;
-
-                        if (rects_overlap(erase_x, erase_y, erase_w, erase_h,
-                                        cell_x, cell_y, GRID_WIDTH, GRID_HEIGHT)) {
-                            draw_single_plant_cell(game, framebuf, row, col);
-                        }
-                    }
-                }
-            }
-
-            // 4. Redraw suns that were covered (CRITICAL: zombie cannot erase suns)
-            for (j = 0; j < MAX_SUNS; j++) {
-                if (game->suns[j].active) {
-                    int sun_x = (int)game->suns[j].x;
-                    int sun_y = (int)game->suns[j].y;
-
-                    if (rects_overlap(erase_x, erase_y, erase_w, erase_h,
-                                    sun_x, sun_y, SUN_SIZE, SUN_SIZE)) {
-                        draw_sprite_transparent(framebuf, sun_x, sun_y,
-                                              gImage_Sun, SUN_SIZE, SUN_SIZE);
-                    }
-                }
-            }
 
-            // 5. Redraw other zombies that were covered (CRITICAL: zombie cannot erase other zombies)
-            int k;
-            for (k = 0; k < MAX_ZOMBIES; k++) {
-                // Don't redraw the zombie we're currently processing (i)
-                // Also skip zombies that will be erased in this phase
-                if (k != i && game->zombies[k].active) {
-                    int other_x = (int)game->zombies[k].x;
-                    int other_y = (int)game->zombies[k].y + ZOMBIE_Y_OFFSET;
-
-                    if (rects_overlap(erase_x, erase_y, erase_w, erase_h,
-                                    other_x, other_y, ZOMBIE_DISPLAY_WIDTH, ZOMBIE_DISPLAY_HEIGHT)) {
-                        // Draw appropriate sprite based on state
-                        if (game->zombies[k].state == ZOMBIE_WALKING) {
-                            draw_zombie_sprite(framebuf, (int)game->zombies[k].x, (int)game->zombies[k].y,
-                                             gImage_walk_ani, game->zombies[k].animation_frame);
-                        } else if (game->zombies[k].state == ZOMBIE_BITING) {
-                            draw_bite_sprite(framebuf, (int)game->zombies[k].x, (int)game->zombies[k].y,
-                                           gImage_bite_ani, game->zombies[k].bite_anim_frame);
-                        }
-                    }
-                }
-            }
-        }
+    // Pre-scaled frame available: no per-pixel scaling
+    const u8 *frame = sprite_cache_bite(frame_index);
+    if (frame) {
+        draw_rows(framebuf, &spans, dst_x, display_y, frame, ZOMBIE_DISPLAY_WIDTH, ROW_KEY_BLACK);
+        return;
     }
 
-    // --- PHASE 2: DRAW ALL NEW ZOMBIE POSITIONS ---
-    for (i = 0; i < MAX_ZOMBIES; i++) {
-        if (game->zombies[i].active) {
-            int curr_x = (int)game->zombies[i].x;
-            int curr_y = (int)game->zombies[i].y;
-
-            // Draw appropriate sprite based on zombie state
-            if (game->zombies[i].state == ZOMBIE_WALKING) {
-                draw_zombie_sprite(framebuf, curr_x, curr_y,
-                                 gImage_walk_ani, game->zombies[i].animation_frame);
-            } else if (game->zombies[i].state == ZOMBIE_BITING) {
-                draw_bite_sprite(framebuf, curr_x, curr_y,
-                               gImage_bite_ani, game->zombies[i].bite_anim_frame);
-            }
-
-            // Update position tracking
-            game->zombies[i].prev_x = curr_x;
-            game->zombies[i].prev_y = curr_y;
-        }
-        else {
-            // Zombie died and erased, set position to -1 to avoid re-erase
-            game->zombies[i].prev_x = -1;
-            game->zombies[i].prev_y = -1;
-        }
-    }
+    blit_zombie_sheet(framebuf, &spans, dst_x, display_y, sheet_data, BITE_SHEET_WIDTH,
+                      col * BITE_FRAME_WIDTH, row * BITE_FRAME_HEIGHT,
+                      BITE_FRAME_WIDTH, BITE_FRAME_HEIGHT);
 }
 
 /* ============================================================ */
@@ -1510,32 +2160,26 @@ void game_draw_zombies(GameState *game, u8 *framebuf)
  */
 void game_shoot_pea(GameState *game, int row, int col)
 {
-    int i;
+    // Take a free pea slot; nothing is shot while every slot is in use
+    int i = POOL_ALLOC(&game->pea_pool);
 
-    // Find an inactive pea slot
-    for (i = 0; i < MAX_PEAS; i++) {
-        if (!game->peas[i].active) {
-            // Activate pea
-            game->peas[i].active = 1;
-            game->peas[i].row = row;
-
-            // Calculate pea start position (center of plant cell)
-            int cell_x = GRID_START_X + col * GRID_WIDTH;
-            int cell_y = GRID_START_Y + row * GRID_HEIGHT;
+    if (i < 0)
+        return;
 
-            game->peas[i].x = (float)(cell_x + GRID_WIDTH - PEA_SIZE / 2);
-            game->peas[i].y = (float)(cell_y + GRID_HEIGHT / 2 - PEA_SIZE / 2);
+    game->peas[i].row = row;
 
-            // Initialize position tracking
-            game->peas[i].prev_x = (int)game->peas[i].x;
-            game->peas[i].prev_y = (int)game->peas[i].y;
+    // Calculate pea start position (center of plant cell)
+    int cell_x = GRID_START_X + col * GRID_WIDTH;
+    int cell_y = GRID_START_Y + row * GRID_HEIGHT;
 
-            game->num_active_peas++;
+    game->peas[i].x = (float)(cell_x + GRID_WIDTH - PEA_SIZE / 2);
+    game->peas[i].y = (float)(cell_y + GRID_HEIGHT / 2 - PEA_SIZE / 2);
+    game->peas[i].tick_x = game->peas[i].x;
+    game->peas[i].tick_y = game->peas[i].y;
+    lane_insert(game->lanes.peas[row], &game->lanes.pea_count[row], &game->peas[0].x, sizeof(Pea), i);
+    pea_place(game, i);
 
-            printf("Pea shot from row %d, col %d\n", row, col);
-            break;
-        }
-    }
+    printf("Pea shot from row %d, col %d\n", row, col);
 }
 
 /**
@@ -1543,35 +2187,36 @@ void game_shoot_pea(GameState *game, int row, int col)
  */
 void game_update_peas(GameState *game)
 {
-    int i, row, col;
+    int n, i, row, col;
+    u16 bits;
 
     // Update peashooter shoot counters and shoot peas
     for (row = 0; row < GRID_ROWS; row++) {
-        for (col = 0; col < GRID_COLS; col++) {
-            if (game->grid[row][col].plant == PLANT_PEASHOOTER) {
-                game->grid[row][col].shoot_counter++;
-
-                // Shoot pea every PEA_SHOOT_INTERVAL ticks (1.45 seconds)
-                if (game->grid[row][col].shoot_counter >= PEA_SHOOT_INTERVAL) {
-                    game->grid[row][col].shoot_counter = 0;
-                    game_shoot_pea(game, row, col);
-                }
+        for (bits = game->plant_type_cols[PLANT_PEASHOOTER][row]; bits; bits &= bits - 1) {
+            col = __builtin_ctz(bits);
+            game->grid[row][col].shoot_counter++;
+
+            // Shoot pea every PEA_SHOOT_INTERVAL ticks (1.45 seconds)
+            if (game->grid[row][col].shoot_counter >= PEA_SHOOT_INTERVAL) {
+                game->grid[row][col].shoot_counter = 0;
+                game_shoot_pea(game, row, col);
             }
         }
     }
 
-    // Update pea positions
-    for (i = 0; i < MAX_PEAS; i++) {
-        if (game->peas[i].active) {
-            // Move pea to the right
-            game->peas[i].x += PEA_SPEED;
+    // Update pea positions; backwards so peas leaving the screen can be
+    // freed on the way
+    for (n = game->pea_pool.count - 1; n >= 0; n--) {
+        i = game->pea_pool.live[n];
 
-            // Check if pea went off screen
-            if (game->peas[i].x > SCREEN_WIDTH) {
-                game->peas[i].active = 0;
-                game->num_active_peas--;
-            }
-        }
+        // Move pea to the right
+        game->peas[i].x += PEA_SPEED;
+
+        // Check if pea went off screen
+        if (game->peas[i].x > SCREEN_WIDTH)
+            pea_free(game, i);
+        else
+            pea_place(game, i);
     }
 
     // Check pea-zombie collisions
@@ -1580,172 +2225,59 @@ void game_update_peas(GameState *game)
 
 /**
  * Check collision between peas and zombies
+ * Each lane's peas and zombies are both sorted by x, so one sweep pairs
+ * every pea with the leftmost live zombie it can reach: a zombie wholly
+ * left of a pea is left of every pea after it too.
  */
 void game_check_pea_zombie_collision(GameState *game)
 {
-    int i, j;
-
-    // Check each active pea
-    for (i = 0; i < MAX_PEAS; i++) {
-        if (!game->peas[i].active) continue;
-
-        int pea_x = (int)game->peas[i].x;
-        int pea_y = (int)game->peas[i].y;
-        int pea_row = game->peas[i].row;
-
-        // Check collision with each zombie in the same row
-        for (j = 0; j < MAX_ZOMBIES; j++) {
-            if (!game->zombies[j].active) continue;
-            if (game->zombies[j].row != pea_row) continue;
+    LaneIndex *lanes = &game->lanes;
+    int row, p, z, i, j;
 
+    for (row = 0; row < GRID_ROWS; row++) {
+        // Freeing a pea or zombie closes up its list, so the same index
+        // then names the next one
+        p = 0;
+        z = 0;
+        while (p < lanes->pea_count[row] && z < lanes->zombie_count[row]) {
+            i = lanes->peas[row][p];
+            j = lanes->zombies[row][z];
+
+            int pea_x = (int)game->peas[i].x;
+            int pea_y = (int)game->peas[i].y;
             int zombie_x = (int)game->zombies[j].x;
             int zombie_y = (int)game->zombies[j].y + ZOMBIE_Y_OFFSET;
 
-            // Check if pea overlaps with zombie
-            if (rects_overlap(pea_x, pea_y, PEA_SIZE, PEA_SIZE,
-                            zombie_x, zombie_y, ZOMBIE_DISPLAY_WIDTH, ZOMBIE_DISPLAY_HEIGHT)) {
-                // Hit! Damage zombie
-                game->zombies[j].health -= PEA_DAMAGE;
-
-                // Deactivate pea
-                game->peas[i].active = 0;
-                game->num_active_peas--;
-
-                printf("Pea hit zombie! Zombie health: %d\n", game->zombies[j].health);
-
-                // Check if zombie died
-                if (game->zombies[j].health <= 0) {
-                    game->zombies[j].active = 0;
-                    game->num_active_zombies--;
-                    printf("Zombie died!\n");
-                }
-
-                break;  // Pea can only hit one zombie
+            // Zombie already behind this pea: no later pea reaches it either
+            if (zombie_x + ZOMBIE_DISPLAY_WIDTH <= pea_x) {
+                z++;
+                continue;
             }
-        }
-    }
-}
-
-/**
- * Draw all peas with two-phase dirty rect optimization
- */
-void game_draw_peas(GameState *game, u8 *framebuf)
-{
-    int i, j, row, col;
-    extern const unsigned char gImage_ProjectilePea[];
-
-    // --- PHASE 1: ERASE ALL OLD POSITIONS ---
-    for (i = 0; i < MAX_PEAS; i++) {
-        int prev_x = game->peas[i].prev_x;
-        int prev_y = game->peas[i].prev_y;
-        int need_erase = 0;
 
-        // Determine if we need to erase
-        if (game->peas[i].active) {
-            need_erase = 1;
-        } else if (prev_x != -1) {
-            need_erase = 1;
-        }
-
-        if (need_erase) {
-            int curr_x = game->peas[i].active ? (int)game->peas[i].x : prev_x;
-
-            // Calculate erase region that covers the entire movement trail
-            // This ensures no ghosting even with fast movement
-            int erase_x = (prev_x < curr_x ? prev_x : curr_x) - PEA_ERASE_MARGIN;
-            int erase_y = prev_y - PEA_ERASE_MARGIN;
-            int erase_w = ((prev_x < curr_x ? curr_x : prev_x) - erase_x) + PEA_SIZE + (PEA_ERASE_MARGIN * 2);
-            int erase_h = PEA_SIZE + (PEA_ERASE_MARGIN * 2);
-
-            // Boundary check
-            if (erase_x < 0) { erase_w += erase_x; erase_x = 0; }
-            if (erase_y < 0) { erase_h += erase_y; erase_y = 0; }
-            if (erase_x + erase_w > SCREEN_WIDTH) erase_w = SCREEN_WIDTH - erase_x;
-            if (erase_y + erase_h > SCREEN_HEIGHT) erase_h = SCREEN_HEIGHT - erase_y;
-
-            // 1. Restore background (SAFE - avoids UI areas)
-            restore_background_rect_safe(framebuf, erase_x, erase_y, erase_w, erase_h);
-
-            // 2. Redraw UI elements if overlapped
-            redraw_ui_if_overlapped(game, framebuf, erase_x, erase_y, erase_w, erase_h);
-
-            // 3. Redraw plants that were covered
-            for (row = 0; row < GRID_ROWS; row++) {
-                for (col = 0; col < GRID_COLS; col++) {
-                    if (game->grid[row][col].plant != PLANT_NONE) {
-                        int cell_x = GRID_START_X + col * GRID_WIDTH;
-                        int cell_y = GRID_START_Y + row * GRID_HEIGHT;
-
-                        if (rects_overlap(erase_x, erase_y, erase_w, erase_h,
-                                        cell_x, cell_y, GRID_WIDTH, GRID_HEIGHT)) {
-                            draw_single_plant_cell(game, framebuf, row, col);
-                        }
-                    }
-                }
+            // Pea short of the leftmost zombie it could hit
+            if (!rects_overlap(pea_x, pea_y, PEA_SIZE, PEA_SIZE,
+                               zombie_x, zombie_y, ZOMBIE_DISPLAY_WIDTH, ZOMBIE_DISPLAY_HEIGHT)) {
+                p++;
+                continue;
             }
 
-            // 4. Redraw suns that were covered
-            for (j = 0; j < MAX_SUNS; j++) {
-                if (game->suns[j].active) {
-                    int sun_x = (int)game->suns[j].x;
-                    int sun_y = (int)game->suns[j].y;
-
-                    if (rects_overlap(erase_x, erase_y, erase_w, erase_h,
-                                    sun_x, sun_y, SUN_SIZE, SUN_SIZE)) {
-                        draw_sprite_transparent(framebuf, sun_x, sun_y,
-                                              gImage_Sun, SUN_SIZE, SUN_SIZE);
-                    }
-                }
-            }
+            // Hit! Damage zombie
+            game->zombies[j].health -= PEA_DAMAGE;
 
-            // 5. Redraw zombies that were covered
-            for (j = 0; j < MAX_ZOMBIES; j++) {
-                if (game->zombies[j].active) {
-                    int zombie_x = (int)game->zombies[j].x;
-                    int zombie_y = (int)game->zombies[j].y + ZOMBIE_Y_OFFSET;
-
-                    if (rects_overlap(erase_x, erase_y, erase_w, erase_h,
-                                    zombie_x, zombie_y, ZOMBIE_DISPLAY_WIDTH, ZOMBIE_DISPLAY_HEIGHT)) {
-                        // Draw appropriate sprite based on state
-                        if (game->zombies[j].state == ZOMBIE_WALKING) {
-                            draw_zombie_sprite(framebuf, (int)game->zombies[j].x, (int)game->zombies[j].y,
-                                             gImage_walk_ani, game->zombies[j].animation_frame);
-                        } else if (game->zombies[j].state == ZOMBIE_BITING) {
-                            draw_bite_sprite(framebuf, (int)game->zombies[j].x, (int)game->zombies[j].y,
-                                           gImage_bite_ani, game->zombies[j].bite_anim_frame);
-                        }
-                    }
-                }
-            }
-        }
-    }
+            // Deactivate pea (a pea can only hit one zombie)
+            pea_free(game, i);
 
-    // --- PHASE 2: DRAW ALL NEW PEA POSITIONS ---
-    for (i = 0; i < MAX_PEAS; i++) {
-        if (game->peas[i].active) {
-            int curr_x = (int)game->peas[i].x;
-            int curr_y = (int)game->peas[i].y;
+            printf("Pea hit zombie! Zombie health: %d\n", game->zombies[j].health);
 
-            if (curr_x >= 0 && curr_y >= 0 &&
-                curr_x + PEA_SIZE <= SCREEN_WIDTH &&
-                curr_y + PEA_SIZE <= SCREEN_HEIGHT) {
-                draw_sprite_transparent(framebuf, curr_x, curr_y,
-                                      gImage_ProjectilePea, PEA_SIZE, PEA_SIZE);
+            // Check if zombie died
+            if (game->zombies[j].health <= 0) {
+                zombie_free(game, j);
+                printf("Zombie died!\n");
             }
-
-            // Update position tracking
-            game->peas[i].prev_x = curr_x;
-            game->peas[i].prev_y = curr_y;
-        }
-        else {
-            // Pea died and erased, set position to -1 to avoid re-erase
-            game->peas[i].prev_x = -1;
-            game->peas[i].prev_y = -1;
         }
     }
 }
 
-
 /* ============================================================ */
 /*   COMPLETE ADDITIONS FOR pvz_game.c (BUG-FIXED VERSION)    */
 /*   Add these at the END of the file (after line 1713)       */
@@ -1757,7 +2289,7 @@ void game_draw_peas(GameState *game, u8 *framebuf)
  */
 int game_check_defeat(GameState *game)
 {
-    int i;
+    int n, i;
 
     // Only check during normal gameplay
     if (game->play_state != GAME_PLAYING) {
@@ -1765,13 +2297,13 @@ int game_check_defeat(GameState *game)
     }
 
     // Check if any zombie has crossed the left boundary
-    for (i = 0; i < MAX_ZOMBIES; i++) {
-        if (game->zombies[i].active) {
-            // Check if zombie x position is less than grid start (breached left boundary)
-            if (game->zombies[i].x < GRID_START_X) {
-                printf("GAME OVER! Zombie breached left boundary at x=%.1f\n", game->zombies[i].x);
-                return 1;
-            }
+    for (n = 0; n < game->zombie_pool.count; n++) {
+        i = game->zombie_pool.live[n];
+
+        // Check if zombie x position is less than grid start (breached left boundary)
+        if (game->zombies[i].x < GRID_START_X) {
+            printf("GAME OVER! Zombie breached left boundary at x=%.1f\n", game->zombies[i].x);
+            return 1;
         }
     }
 
@@ -1784,7 +2316,7 @@ int game_check_defeat(GameState *game)
  */
 void game_trigger_defeat(GameState *game)
 {
-    int i;
+    int n, i;
 
     printf("Triggering defeat sequence...\n");
 
@@ -1795,8 +2327,9 @@ void game_trigger_defeat(GameState *game)
     game->defeat_scale = DEFEAT_MIN_SCALE;
 
     // Make all zombies that crossed the boundary start biting
-    for (i = 0; i < MAX_ZOMBIES; i++) {
-        if (game->zombies[i].active && game->zombies[i].x < GRID_START_X) {
+    for (n = 0; n < game->zombie_pool.count; n++) {
+        i = game->zombie_pool.live[n];
+        if (game->zombies[i].x < GRID_START_X) {
             game->zombies[i].state = ZOMBIE_BITING;
             game->zombies[i].bite_timer = BITE_DURATION;
             game->zombies[i].bite_anim_frame = 0;
@@ -1861,33 +2394,18 @@ void game_update_gameover(GameState *game)
  */
 void game_draw_fade_to_black(u8 *framebuf, float progress)
 {
-    int i;
     int total_pixels = SCREEN_WIDTH * SCREEN_HEIGHT;
     int fade_factor = (int)(progress * 256.0f); // 0-256
 
     if (fade_factor > 256) fade_factor = 256;
     if (fade_factor <= 0) return;
 
-    // Darken all pixels by reducing RGB values
-    // Using bit shift for fast division by 256
-    for (i = 0; i < total_pixels; i++) {
-        int idx = i * 3;
-
-        // Reduce each color channel
-        int b = framebuf[idx];
-        int g = framebuf[idx + 1];
-        int r = framebuf[idx + 2];
-
-        // Apply fade: pixel = pixel * (1 - progress)
-        // Using integer arithmetic for speed: pixel * (256 - fade_factor) / 256
-        b = (b * (256 - fade_factor)) >> 8;
-        g = (g * (256 - fade_factor)) >> 8;
-        r = (r * (256 - fade_factor)) >> 8;
+    damage_add_full();
 
-        framebuf[idx]     = (u8)b;
-        framebuf[idx + 1] = (u8)g;
-        framebuf[idx + 2] = (u8)r;
-    }
+    // Apply fade: pixel = pixel * (1 - progress)
+    // Using integer arithmetic for speed: pixel * (256 - fade_factor) / 256
+    // Every channel is scaled the same, so the frame is one flat byte run
+    kern->scale_bytes(framebuf, total_pixels * 3, 256 - fade_factor);
 }
 
 /**
@@ -1896,6 +2414,7 @@ void game_draw_fade_to_black(u8 *framebuf, float progress)
  */
 void game_fill_black(u8 *framebuf)
 {
+    damage_add_full();
     memset(framebuf, 0, SCREEN_WIDTH * SCREEN_HEIGHT * 3);
 }
 
@@ -1932,28 +2451,24 @@ void game_draw_defeat_image(u8 *framebuf, float scale)
     // BUG FIX: Double check after boundary adjustment
     if (scaled_w < 1 || scaled_h < 1) return;
 
+    damage_add(dst_x, dst_y, scaled_w, scaled_h);
+
     // Draw scaled image using nearest neighbor sampling (fast)
+    // Table entries are < DEFEAT_IMAGE_* since scaled_w/h >= 1, and the
+    // destination was clipped to the screen above
+    const ScaleTable *tx = scale_table_get(DEFEAT_IMAGE_WIDTH, scaled_w, scaled_w);
+    const ScaleTable *ty = scale_table_get(DEFEAT_IMAGE_HEIGHT, scaled_h, scaled_h);
+
     for (i = 0; i < scaled_h; i++) {
-        for (j = 0; j < scaled_w; j++) {
-            // Map destination pixel to source pixel
-            int src_x = (j * DEFEAT_IMAGE_WIDTH) / scaled_w;
-            int src_y = (i * DEFEAT_IMAGE_HEIGHT) / scaled_h;
-
-            // Clamp source coordinates (safety check)
-            if (src_x >= DEFEAT_IMAGE_WIDTH) src_x = DEFEAT_IMAGE_WIDTH - 1;
-            if (src_y >= DEFEAT_IMAGE_HEIGHT) src_y = DEFEAT_IMAGE_HEIGHT - 1;
-            if (src_x < 0) src_x = 0;
-            if (src_y < 0) src_y = 0;
-
-            int fb_idx = ((dst_y + i) * SCREEN_WIDTH + (dst_x + j)) * 3;
-            int src_idx = (src_y * DEFEAT_IMAGE_WIDTH + src_x) * 3;
-
-            // BUG FIX: Add bounds check for framebuffer index
-            if (fb_idx >= 0 && fb_idx + 2 < SCREEN_WIDTH * SCREEN_HEIGHT * 3) {
-                framebuf[fb_idx]     = gImage_ZombiesWon_ani[src_idx];
-                framebuf[fb_idx + 1] = gImage_ZombiesWon_ani[src_idx + 1];
-                framebuf[fb_idx + 2] = gImage_ZombiesWon_ani[src_idx + 2];
-            }
+        const u8 *src_row = gImage_ZombiesWon_ani + ty->index[i] * DEFEAT_IMAGE_WIDTH * 3;
+        u8 *dst = framebuf + ((dst_y + i) * SCREEN_WIDTH + dst_x) * 3;
+
+        for (j = 0; j < scaled_w; j++, dst += 3) {
+            const u8 *src = src_row + tx->index[j] * 3;
+
+            dst[0] = src[0];
+            dst[1] = src[1];
+            dst[2] = src[2];
         }
     }
 }
@@ -1974,7 +2489,6 @@ void game_reset(GameState *game)
     game->animation_counter = 0;
     game->prev_sun_count = 150;
     game->prev_selected_card = -1;
-    game->num_active_suns = 0;
 
     // Reset cards
     game->cards[0].type = PLANT_SUNFLOWER;
@@ -1994,22 +2508,18 @@ void game_reset(GameState *game)
             game->grid[i][j].shoot_counter = 0;
         }
     }
+    memset(game->plant_cols, 0, sizeof(game->plant_cols));
+    memset(game->plant_type_cols, 0, sizeof(game->plant_type_cols));
 
     // Clear suns
-    for (i = 0; i < MAX_SUNS; i++) {
-        game->suns[i].active = 0;
-        game->suns[i].prev_x = -1;
-    }
+    POOL_INIT(&game->sun_pool);
 
     // Clear zombies
-    game->num_active_zombies = 0;
+    POOL_INIT(&game->zombie_pool);
     game->zombie_spawn_counter = 0;
     game->zombie_animation_counter = 0;
     game->bite_animation_counter = 0;
     for (i = 0; i < MAX_ZOMBIES; i++) {
-        game->zombies[i].active = 0;
-        game->zombies[i].prev_x = -1;
-        game->zombies[i].prev_y = -1;
         game->zombies[i].health = 0;
         game->zombies[i].state = ZOMBIE_WALKING;
         game->zombies[i].target_col = -1;
@@ -2018,12 +2528,9 @@ void game_reset(GameState *game)
     }
 
     // Clear peas
-    game->num_active_peas = 0;
-    for (i = 0; i < MAX_PEAS; i++) {
-        game->peas[i].active = 0;
-        game->peas[i].prev_x = -1;
-        game->peas[i].prev_y = -1;
-    }
+    POOL_INIT(&game->pea_pool);
+    memset(&game->lanes, 0, sizeof(game->lanes));
+    SGRID_INIT(&game->sprites);
 
     // Reset game over state to playing
     game->play_state = GAME_PLAYING;
@@ -5,6 +5,9 @@
 #define PVZ_GAME_H
 
 #include "xil_types.h"
+#include "clip.h"
+#include "entity_pool.h"
+#include "spatial_grid.h"
 
 /* Screen parameters */
 #define SCREEN_WIDTH   800
@@ -21,11 +24,20 @@
 /* Plant display size */
 #define PLANT_SIZE     58
 
+/* Top-left corner of the plant sprite drawn in a grid cell */
+#define PLANT_DRAW_X(col)  (GRID_START_X + (col) * GRID_WIDTH + (GRID_WIDTH - PLANT_SIZE) / 2)
+#define PLANT_DRAW_Y(row)  (GRID_START_Y + (row) * GRID_HEIGHT + (GRID_HEIGHT - PLANT_SIZE) / 2)
+
 /* Animation parameters */
 #define ANIMATION_FRAMES     25
 #define ANIMATION_FPS        12
 #define TIMER_FREQ_HZ        100
 #define FRAMES_PER_UPDATE    8
+
+/* Tick (0..FRAMES_PER_UPDATE-1) on which a cell's plant advances its frame:
+ * neighbouring cells fall on different ticks, so only about one cell in
+ * FRAMES_PER_UPDATE has to be redrawn per tick instead of all at once */
+#define PLANT_ANIM_PHASE(row, col)  (((row) * GRID_COLS + (col)) % FRAMES_PER_UPDATE)
 #define SPRITE_SHEET_SIZE    400
 #define FRAME_SIZE           80
 #define SPRITE_COLS          5
@@ -33,7 +45,9 @@
 
 /* Sun parameters */
 #define SUN_SIZE             40
+#ifndef MAX_SUNS
 #define MAX_SUNS             20
+#endif
 #define SUN_SPAWN_INTERVAL   2500
 #define SUN_LIFETIME         800
 #define SUN_VALUE            25
@@ -41,7 +55,6 @@
 #define SUN_INITIAL_VY       -2.5f
 #define SUN_INITIAL_VX       1.2f
 #define SUN_LANDING_HEIGHT   380
-#define SUN_ERASE_MARGIN     20
 
 /* UI position parameters */
 #define SEEDBANK_X     220
@@ -66,6 +79,12 @@
 #define SUNBANK_WIDTH    80
 #define SUNBANK_HEIGHT   35
 
+/* Area repainted when a bank is redrawn */
+#define SUNBANK_DRAW_WIDTH    93
+#define SUNBANK_DRAW_HEIGHT   70
+#define SEEDBANK_DRAW_WIDTH   357
+#define SEEDBANK_DRAW_HEIGHT  70
+
 /* Card parameters */
 #define CARD_WIDTH     45
 #define CARD_HEIGHT    63
@@ -81,6 +100,7 @@ typedef enum {
     PLANT_SUNFLOWER = 1,
     PLANT_PEASHOOTER = 2
 } PlantType;
+#define NUM_PLANT_TYPES  3
 
 /* Plant costs */
 #define SUNFLOWER_COST   50
@@ -104,9 +124,8 @@ typedef struct {
 /* Sun object for collection */
 typedef struct {
     float x, y;
+    float tick_x, tick_y;   /* position before the last tick (interpolation) */
     float vx, vy;
-    int prev_x, prev_y;
-    u8 active;
     u8 landed;
     u16 lifetime;
 } Sun;
@@ -118,19 +137,22 @@ typedef struct {
 #define ZOMBIE_SHEET_HEIGHT  834
 #define ZOMBIE_ROWS          6
 #define ZOMBIE_COLS          8
+#ifndef MAX_ZOMBIES
 #define MAX_ZOMBIES          10
+#endif
 #define ZOMBIE_SPEED         0.2f
 #define ZOMBIE_SPAWN_X       800
 #define ZOMBIE_ANIMATION_FPS 8
 #define ZOMBIE_FRAMES_PER_UPDATE  (TIMER_FREQ_HZ / ZOMBIE_ANIMATION_FPS)
 #define ZOMBIE_SPAWN_INTERVAL 1000
-#define ZOMBIE_ERASE_MARGIN  5
 
 /* Zombie rendering adjustments */
 #define ZOMBIE_Y_OFFSET      -15
-#define ZOMBIE_SCALE         0.8f
-#define ZOMBIE_DISPLAY_WIDTH  ((int)(ZOMBIE_WIDTH * ZOMBIE_SCALE))
-#define ZOMBIE_DISPLAY_HEIGHT ((int)(ZOMBIE_HEIGHT * ZOMBIE_SCALE))
+#define ZOMBIE_SCALE_PERCENT 80
+#define ZOMBIE_SCALE         (ZOMBIE_SCALE_PERCENT / 100.0f)
+// Integer constant expressions so they can size static arrays
+#define ZOMBIE_DISPLAY_WIDTH  (ZOMBIE_WIDTH * ZOMBIE_SCALE_PERCENT / 100)
+#define ZOMBIE_DISPLAY_HEIGHT (ZOMBIE_HEIGHT * ZOMBIE_SCALE_PERCENT / 100)
 
 /* Bite animation parameters */
 #define BITE_FRAME_WIDTH     80
@@ -153,10 +175,9 @@ typedef enum {
 /* Zombie object */
 typedef struct {
     float x, y;
-    int prev_x, prev_y;
+    float tick_x, tick_y;   /* position before the last tick (interpolation) */
     int row;
     int animation_frame;
-    u8 active;
     int health;
     ZombieState state;
     int target_col;
@@ -166,21 +187,47 @@ typedef struct {
 
 /* Pea projectile parameters */
 #define PEA_SIZE             24
+#ifndef MAX_PEAS
 #define MAX_PEAS             50
+#endif
 #define PEA_SPEED            3.0f
 #define PEA_DAMAGE           1
 #define PEA_SHOOT_INTERVAL   145
-#define PEA_ERASE_MARGIN     12
 #define ZOMBIE_MAX_HEALTH    10
 
 /* Pea projectile object */
 typedef struct {
     float x, y;
-    int prev_x, prev_y;
+    float tick_x, tick_y;   /* position before the last tick (interpolation) */
     int row;
-    u8 active;
 } Pea;
 
+/*
+ * Zombie and pea slots by lane (grid row), each lane sorted by x from
+ * left to right, so collisions are a merge of two sorted lists per lane.
+ * Peas all fly at one speed and keep their order; zombies that stop to
+ * bite get overtaken, so zombie lanes are re-sorted after every move.
+ */
+typedef struct {
+    u16 zombie_count[GRID_ROWS];
+    u16 pea_count[GRID_ROWS];
+    u16 zombies[GRID_ROWS][MAX_ZOMBIES];
+    u16 peas[GRID_ROWS][MAX_PEAS];
+} LaneIndex;
+
+/*
+ * Sprite ids: one per grid cell and per entity slot. Each sprite on
+ * screen registers its bounds under its id in the game's spatial grid
+ * (spatial_grid.h), which the renderer asks what a damaged region
+ * touches. Moving entities register every position they can be drawn
+ * at between their previous and newest tick.
+ */
+#define SPRITE_ID_PLANT(row, col)  ((row) * GRID_COLS + (col))
+#define SPRITE_ID_SUN(slot)        (GRID_ROWS * GRID_COLS + (slot))
+#define SPRITE_ID_ZOMBIE(slot)     (SPRITE_ID_SUN(MAX_SUNS) + (slot))
+#define SPRITE_ID_PEA(slot)        (SPRITE_ID_ZOMBIE(MAX_ZOMBIES) + (slot))
+#define NUM_SPRITE_IDS             SPRITE_ID_PEA(MAX_PEAS)
+
 /* Game play state enum */
 typedef enum {
     GAME_PLAYING = 0,
@@ -202,18 +249,26 @@ typedef struct {
     int sun_count;
     SeedCard cards[NUM_CARDS];
     GridCell grid[GRID_ROWS][GRID_COLS];
+    /* Cells holding a plant as column bits per row, overall and per
+     * type (plant_type_cols[PLANT_NONE] stays 0); set by game_set_plant */
+    u16 plant_cols[GRID_ROWS];
+    u16 plant_type_cols[NUM_PLANT_TYPES][GRID_ROWS];
     int selected_card;
     int animation_counter;
     int prev_sun_count;
     int prev_selected_card;
+
+    /* Entity slots; each pool lists the live ones (entity_pool.h) */
     Sun suns[MAX_SUNS];
-    int num_active_suns;
+    ENTITY_POOL(MAX_SUNS) sun_pool;
     Zombie zombies[MAX_ZOMBIES];
-    int num_active_zombies;
+    ENTITY_POOL(MAX_ZOMBIES) zombie_pool;
     int zombie_spawn_counter;
     int zombie_animation_counter;
     Pea peas[MAX_PEAS];
-    int num_active_peas;
+    ENTITY_POOL(MAX_PEAS) pea_pool;
+    LaneIndex lanes;
+    SPATIAL_GRID(NUM_SPRITE_IDS) sprites;
     int bite_animation_counter;
 
     /* Game over state */
@@ -221,50 +276,75 @@ typedef struct {
     int game_over_timer;
     float fade_progress;
     float defeat_scale;
+
+    /* Global timer count when the newest simulated tick was due;
+     * 0 while the simulation is behind (draw the newest tick as is) */
+    u64 tick_time;
 } GameState;
 
 /* Function declarations */
 void game_init(GameState *game);
+
+/* Render-time interpolation between the last two simulated ticks */
+void game_begin_tick(GameState *game);
+void game_set_interpolation(float alpha);
 void game_draw_full(GameState *game, u8 *framebuf);
-void game_draw_animation(GameState *game, u8 *framebuf);
-void game_draw_suns(GameState *game, u8 *framebuf);
 void game_handle_touch(GameState *game, int x, int y);
+void game_set_plant(GameState *game, int row, int col, PlantType type);
 int game_update_animation(GameState *game);
+void game_set_anim_stagger(int enable);
 void game_update_suns(GameState *game);
 void game_spawn_sun(GameState *game, int source_x, int source_y);
 int game_check_sun_click(GameState *game, int x, int y);
-void draw_single_plant_cell(GameState *game, u8 *framebuf, int row, int col);
+void draw_single_plant_cell(GameState *game, u8 *framebuf, int row, int col,
+                            const ClipRegion *clip);
+
+/* Draw primitives: clip NULL = whole screen */
 void draw_sprite_scaled(u8 *framebuf, int dst_x, int dst_y, int dst_w, int dst_h,
-                        const u8 *sprite_data, int src_w, int src_h);
+                        const u8 *sprite_data, int src_w, int src_h, const ClipRegion *clip);
 void draw_sprite_scaled_transparent(u8 *framebuf, int dst_x, int dst_y, int dst_w, int dst_h,
-                                    const u8 *sprite_data, int src_w, int src_h);
+                                    const u8 *sprite_data, int src_w, int src_h,
+                                    const ClipRegion *clip);
 void draw_sprite_from_sheet(u8 *framebuf, int dst_x, int dst_y, int dst_w, int dst_h,
-                            const u8 *sheet_data, int frame_index);
-void draw_sprite(u8 *framebuf, int x, int y, const u8 *sprite_data, int w, int h);
-void draw_sprite_transparent(u8 *framebuf, int x, int y, const u8 *sprite_data, int w, int h);
-void draw_number(u8 *framebuf, int x, int y, int number);
-void restore_background_rect(u8 *framebuf, int x, int y, int w, int h);
-void draw_sprite_darkened(u8 *framebuf, int x, int y, const u8 *sprite_data, int w, int h);
+                            const u8 *sheet_data, int frame_index, const ClipRegion *clip);
+void draw_sprite(u8 *framebuf, int x, int y, const u8 *sprite_data, int w, int h,
+                 const ClipRegion *clip);
+void draw_sprite_transparent(u8 *framebuf, int x, int y, const u8 *sprite_data, int w, int h,
+                             const ClipRegion *clip);
+void draw_number(u8 *framebuf, int x, int y, int number, const ClipRegion *clip);
+void restore_background_rect(u8 *framebuf, int x, int y, int w, int h, const ClipRegion *clip);
+void draw_sprite_darkened(u8 *framebuf, int x, int y, const u8 *sprite_data, int w, int h,
+                          const ClipRegion *clip);
 
 /* Helper functions */
 int is_in_ui_protected_area(int x, int y, int w, int h);
 void restore_background_rect_safe(u8 *framebuf, int x, int y, int w, int h);
 void redraw_ui_if_overlapped(GameState *game, u8 *framebuf, int erase_x, int erase_y, int erase_w, int erase_h);
 
+/* Clean plate (background + UI banks) */
+void plate_update(GameState *game);
+
+/* Damage composition */
+void game_post_damage(int x, int y, int w, int h);
+void game_post_stale(int x, int y, int w, int h);
+int game_damage_changes(GameState *game);
+void game_draw_damage(GameState *game, u8 *framebuf);
+
 /* UI redraw functions */
 void redraw_ui_if_overlapped(GameState *game, u8 *framebuf, int erase_x, int erase_y, int erase_w, int erase_h);
 
 /* Zombie functions */
 void game_spawn_zombie(GameState *game);
 void game_update_zombies(GameState *game);
-void game_draw_zombies(GameState *game, u8 *framebuf);
-void draw_zombie_sprite(u8 *framebuf, int dst_x, int dst_y, const u8 *sheet_data, int frame_index);
-void draw_bite_sprite(u8 *framebuf, int dst_x, int dst_y, const u8 *sheet_data, int frame_index);
+int game_nearest_zombie_right(const GameState *game, int row, float x);
+void draw_zombie_sprite(u8 *framebuf, int dst_x, int dst_y, const u8 *sheet_data, int frame_index,
+                        const ClipRegion *clip);
+void draw_bite_sprite(u8 *framebuf, int dst_x, int dst_y, const u8 *sheet_data, int frame_index,
+                      const ClipRegion *clip);
 
 /* Pea functions */
 void game_shoot_pea(GameState *game, int row, int col);
 void game_update_peas(GameState *game);
-void game_draw_peas(GameState *game, u8 *framebuf);
 void game_check_pea_zombie_collision(GameState *game);
 
 /* Game over functions */
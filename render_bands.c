@@ -0,0 +1,110 @@
+/* ------------------------------------------------------------ */
+/*          Banded Rendering (Both Cores Compose a Frame)       */
+/* ------------------------------------------------------------ */
+#include "render_bands.h"
+#include "smp.h"
+
+// Band edges: band b covers band_y[b] <= y < band_y[b + 1]
+static int band_y[BANDS_NUM + 1];
+static u8 enabled = 0;
+
+// Open job. job_work packs the job generation (upper bits) with the
+// next band to hand out (low byte), so a core still holding an old
+// generation can never take a band of a newer job.
+static BandComposeFn job_compose;
+static void *job_arg;
+static u32 job_work = BANDS_NUM;   // generation 0, every band taken
+static u32 job_done = 0;
+
+#define WORK_BAND(w)         ((w) & 0xFF)
+#define WORK_GEN(w)          ((w) >> 8)
+#define WORK_GEN_MASK        0xFFFFFF
+
+void bands_init(int enable)
+{
+    int b;
+
+    band_y[0] = 0;
+    for (b = 1; b < BANDS_NUM; b++)
+        band_y[b] = GRID_START_Y + (b - 1) * GRID_HEIGHT;
+    band_y[BANDS_NUM] = SCREEN_HEIGHT;
+
+    enabled = enable;
+}
+
+void bands_set_enabled(int enable)
+{
+    enabled = enable;
+}
+
+int bands_enabled(void)
+{
+    return enabled;
+}
+
+void bands_get(int b, int *y0, int *y1)
+{
+    *y0 = band_y[b];
+    *y1 = band_y[b + 1];
+}
+
+/**
+ * Take and compose bands of job generation gen until none are left
+ * Returns the number of bands composed.
+ */
+static int run_bands(u32 gen)
+{
+    u32 w = __atomic_load_n(&job_work, __ATOMIC_ACQUIRE);
+    int count = 0;
+
+    while (WORK_GEN(w) == gen && WORK_BAND(w) < BANDS_NUM) {
+        // On failure w is reloaded and checked again
+        if (!__atomic_compare_exchange_n(&job_work, &w, w + 1, 0,
+                                         __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+            continue;
+
+        job_compose(band_y[WORK_BAND(w)], band_y[WORK_BAND(w) + 1], job_arg);
+        __atomic_add_fetch(&job_done, 1, __ATOMIC_RELEASE);
+        count++;
+
+        w = __atomic_load_n(&job_work, __ATOMIC_ACQUIRE);
+    }
+
+    return count;
+}
+
+/**
+ * Renderer: open a job for every band, take bands until none are left,
+ * then wait for the helper to finish the ones it took
+ */
+void bands_run(BandComposeFn compose, void *arg)
+{
+    u32 gen = (WORK_GEN(__atomic_load_n(&job_work, __ATOMIC_RELAXED)) + 1) & WORK_GEN_MASK;
+
+    // Published by the release store of the new generation
+    job_compose = compose;
+    job_arg = arg;
+    __atomic_store_n(&job_done, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&job_work, gen << 8, __ATOMIC_RELEASE);
+    smp_signal();
+
+    run_bands(gen);
+
+    while (__atomic_load_n(&job_done, __ATOMIC_ACQUIRE) < BANDS_NUM)
+        smp_wait();
+}
+
+/**
+ * Helper core: join the open job, if any
+ */
+int bands_help(void)
+{
+    u32 w = __atomic_load_n(&job_work, __ATOMIC_ACQUIRE);
+
+    if (WORK_BAND(w) >= BANDS_NUM || !run_bands(WORK_GEN(w)))
+        return 0;
+
+    // The renderer may be waiting for the bands taken here
+    smp_signal();
+    return 1;
+}
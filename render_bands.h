@@ -0,0 +1,55 @@
+/* ------------------------------------------------------------ */
+/*          Banded Rendering (Both Cores Compose a Frame)       */
+/* ------------------------------------------------------------ */
+#ifndef RENDER_BANDS_H
+#define RENDER_BANDS_H
+
+#include "xil_types.h"
+#include "pvz_game.h"
+
+/*
+ * The screen is cut into horizontal bands: the UI strip above the lawn
+ * and one band per lawn row (the last one runs to the bottom edge).
+ * The rendering core opens a job, both cores take bands from it until
+ * none are left, and the renderer returns once every band is composed.
+ * Bands are handed out dynamically, so an idle helper takes more of
+ * them and a busy one (simulating) may take none.
+ */
+
+/* UI strip plus one band per lawn row */
+#define BANDS_NUM            (1 + GRID_ROWS)
+
+/* Damage smaller than this (pixels) is composed by the renderer alone:
+ * waking the helper would cost more than the rows it takes over */
+#ifndef BANDS_MIN_AREA
+#define BANDS_MIN_AREA       (16 * 1024)
+#endif
+
+/* Compose rows y0 <= y < y1 of the frame described by arg */
+typedef void (*BandComposeFn)(int y0, int y1, void *arg);
+
+/**
+ * Build the band table and turn banded rendering on or off
+ * Turn it on once the other core runs bands_help from its idle loop;
+ * with no helper the renderer would compose every band itself.
+ */
+void bands_init(int enable);
+void bands_set_enabled(int enable);
+int bands_enabled(void);
+
+/* Rows covered by band b */
+void bands_get(int b, int *y0, int *y1);
+
+/**
+ * Renderer: run compose for every band on both cores and return when
+ * all are done. compose must only read shared state.
+ */
+void bands_run(BandComposeFn compose, void *arg);
+
+/**
+ * Helper core: compose bands of the open job, if there is one
+ * Returns nonzero if any band was composed here.
+ */
+int bands_help(void);
+
+#endif // RENDER_BANDS_H
@@ -0,0 +1,133 @@
+/* ------------------------------------------------------------ */
+/*            Run-Length Encoded Transparent Sprites            */
+/* ------------------------------------------------------------ */
+#include "rle_sprite.h"
+#include "pvz_game.h"
+#include <string.h>
+
+static u8 rle_pool[RLE_POOL_BYTES];
+static u32 rle_pool_pos = 0;
+
+#define RD16(p)  ((u16)((p)[0] | ((p)[1] << 8)))
+
+static void wr16(u8 *p, u32 v)
+{
+    p[0] = (u8)(v & 0xFF);
+    p[1] = (u8)(v >> 8);
+}
+
+static int is_transparent(const u8 *px, int threshold)
+{
+    return (int)px[0] + (int)px[1] + (int)px[2] < threshold;
+}
+
+void rle_pool_reset(void)
+{
+    rle_pool_pos = 0;
+}
+
+u32 rle_pool_used(void)
+{
+    return rle_pool_pos;
+}
+
+int rle_encode(RleSprite *out, const u8 *pixels, int w, int h, int threshold)
+{
+    u32 pos = rle_pool_pos;
+    u32 opaque = 0;
+    int i, j;
+
+    out->data = NULL;
+
+    for (i = 0; i < h; i++) {
+        const u8 *row = pixels + i * w * 3;
+        u32 count_pos = pos;
+        int spans = 0;
+        int last_end = 0;
+
+        if (pos + 2 > RLE_POOL_BYTES) return 0;
+        pos += 2;
+
+        j = 0;
+        while (j < w) {
+            int start, len;
+
+            // Skip transparent pixels
+            while (j < w && is_transparent(row + j * 3, threshold)) j++;
+            if (j >= w) break;
+
+            // Opaque run
+            start = j;
+            while (j < w && !is_transparent(row + j * 3, threshold)) j++;
+            len = j - start;
+
+            if (pos + 4 + len * 3 > RLE_POOL_BYTES) return 0;
+            wr16(rle_pool + pos, start - last_end);
+            wr16(rle_pool + pos + 2, len);
+            memcpy(rle_pool + pos + 4, row + start * 3, len * 3);
+            pos += 4 + len * 3;
+
+            opaque += len;
+            last_end = j;
+            spans++;
+        }
+
+        wr16(rle_pool + count_pos, spans);
+    }
+
+    out->w = w;
+    out->h = h;
+    out->bytes = pos - rle_pool_pos;
+    out->opaque_pixels = opaque;
+    out->data = rle_pool + rle_pool_pos;
+    rle_pool_pos = pos;
+    return 1;
+}
+
+void rle_blit(u8 *framebuf, int x, int y, const RleSprite *sprite, const ClipSpans *clip)
+{
+    const u8 *p = sprite->data;
+    const ClipBand *band = clip->bands;
+    const ClipBand *band_end = clip->bands + clip->num_bands;
+    int i, s, k;
+
+    for (i = 0; i < sprite->h; i++) {
+        int spans = RD16(p);
+        int py = y + i;
+        int px = x;
+        u8 *dst_row;
+
+        p += 2;
+
+        while (band < band_end && band->y1 <= py)
+            band++;
+
+        // Rows outside the clip are walked but not drawn
+        if (band == band_end || py < band->y0) {
+            for (s = 0; s < spans; s++)
+                p += 4 + RD16(p + 2) * 3;
+            continue;
+        }
+
+        dst_row = framebuf + py * SCREEN_WIDTH * 3;
+
+        for (s = 0; s < spans; s++) {
+            int len = RD16(p + 2);
+            const u8 *src = p + 4;
+
+            px += RD16(p);
+            p += 4 + len * 3;
+
+            // Intersect the run with every visible span of the row
+            for (k = 0; k < band->num_spans; k++) {
+                int x0 = px > band->spans[k].x0 ? px : band->spans[k].x0;
+                int x1 = px + len < band->spans[k].x1 ? px + len : band->spans[k].x1;
+
+                if (x0 < x1)
+                    memcpy(dst_row + x0 * 3, src + (x0 - px) * 3, (x1 - x0) * 3);
+            }
+
+            px += len;
+        }
+    }
+}
@@ -0,0 +1,48 @@
+/* ------------------------------------------------------------ */
+/*            Run-Length Encoded Transparent Sprites            */
+/* ------------------------------------------------------------ */
+#ifndef RLE_SPRITE_H
+#define RLE_SPRITE_H
+
+#include "xil_types.h"
+#include "clip.h"
+
+/* Static pool holding every encoded sprite (DDR, not heap) */
+#ifndef RLE_POOL_BYTES
+#define RLE_POOL_BYTES       (3 * 1024 * 1024)
+#endif
+
+/* Transparency thresholds: pixel is transparent if b + g + r < threshold */
+#define RLE_KEY_BLACK        1      /* exact (0,0,0), as the sprite sheets use */
+#define RLE_KEY_NEAR_BLACK   30     /* as draw_sprite_transparent uses */
+
+/*
+ * Encoded layout, rows back to back, all counts little-endian u16:
+ *   row:  span_count, span * span_count
+ *   span: skip, len, len * 3 pixel bytes (BGR)
+ * skip is measured from the end of the previous span in the same row.
+ */
+typedef struct {
+    u16 w, h;
+    u32 bytes;              // encoded size
+    u32 opaque_pixels;
+    const u8 *data;         // NULL = not encoded
+} RleSprite;
+
+/**
+ * Encode a w x h BGR sprite into the pool
+ * Returns 0 if the pool is full (sprite is left unencoded).
+ */
+int rle_encode(RleSprite *out, const u8 *pixels, int w, int h, int threshold);
+
+/**
+ * Draw an encoded sprite, clipped to precomputed spans
+ * Opaque runs are copied with memcpy; transparent runs are skipped untested.
+ */
+void rle_blit(u8 *framebuf, int x, int y, const RleSprite *sprite, const ClipSpans *clip);
+
+/* Pool bookkeeping */
+void rle_pool_reset(void);
+u32 rle_pool_used(void);
+
+#endif // RLE_SPRITE_H
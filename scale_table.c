@@ -0,0 +1,72 @@
+/* ------------------------------------------------------------ */
+/*               Nearest-Neighbor Scaling Tables                */
+/* ------------------------------------------------------------ */
+#include "scale_table.h"
+
+// One cache per core: both cores draw when a frame is rendered in bands
+#ifdef PVZ_DUAL_CORE
+#include "smp.h"
+#define TABLE_SETS           SMP_NUM_CORES
+#define TABLE_SET()          smp_core_id()
+#else
+#define TABLE_SETS           1
+#define TABLE_SET()          0
+#endif
+
+static ScaleTable table_sets[TABLE_SETS][SCALE_TABLE_CACHE];
+static int next_victims[TABLE_SETS];
+
+/**
+ * Fill a table with a fixed-point DDA: integer step plus a remainder
+ * carried against den, so every entry is exactly floor(j * num / den)
+ * (a plain 16.16 step drifts by one source pixel on long rows)
+ */
+static void scale_table_build(ScaleTable *t, int num, int den, int count)
+{
+    int step = num / den;
+    int rem = num % den;
+    int src = 0, err = 0;
+    int j;
+
+    t->num = num;
+    t->den = den;
+    t->count = count;
+
+    for (j = 0; j < count; j++) {
+        t->index[j] = src;
+        src += step;
+        err += rem;
+        if (err >= den) {
+            err -= den;
+            src++;
+        }
+    }
+}
+
+const ScaleTable *scale_table_get(int num, int den, int count)
+{
+    ScaleTable *tables = table_sets[TABLE_SET()];
+    int *next_victim = &next_victims[TABLE_SET()];
+    ScaleTable *t;
+    int i;
+
+    if (count > SCALE_TABLE_MAX) count = SCALE_TABLE_MAX;
+    if (count < 0) count = 0;
+    if (den < 1) den = 1;
+
+    for (i = 0; i < SCALE_TABLE_CACHE; i++) {
+        t = &tables[i];
+        if (t->den && t->num == num && t->den == den && t->count == count) {
+            // Never hand out the next victim: callers hold an x and a y table
+            if (*next_victim == i)
+                *next_victim = (*next_victim + 1) % SCALE_TABLE_CACHE;
+            return t;
+        }
+    }
+
+    // Round-robin replacement; entries are cheap to rebuild
+    t = &tables[*next_victim];
+    *next_victim = (*next_victim + 1) % SCALE_TABLE_CACHE;
+    scale_table_build(t, num, den, count);
+    return t;
+}
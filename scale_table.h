@@ -0,0 +1,29 @@
+/* ------------------------------------------------------------ */
+/*               Nearest-Neighbor Scaling Tables                */
+/* ------------------------------------------------------------ */
+#ifndef SCALE_TABLE_H
+#define SCALE_TABLE_H
+
+#include "xil_types.h"
+
+/* Longest table (output pixels per row or column) */
+#define SCALE_TABLE_MAX      800
+
+/* Number of recently used tables kept */
+#define SCALE_TABLE_CACHE    8
+
+/* index[j] = floor(j * num / den) for j < count */
+typedef struct {
+    u16 num, den, count;
+    u16 index[SCALE_TABLE_MAX];
+} ScaleTable;
+
+/**
+ * Get the source-index table for output length count
+ * For a plain resize use num = src_len, den = dst_len, count = dst_len.
+ * Tables are built without divisions in the loop and cached per
+ * (num, den, count), so inner blit loops only do table lookups.
+ */
+const ScaleTable *scale_table_get(int num, int den, int count);
+
+#endif // SCALE_TABLE_H
@@ -0,0 +1,241 @@
+/* ------------------------------------------------------------ */
+/*             Second Core Start-up (Zynq CPU1)                 */
+/* ------------------------------------------------------------ */
+#include "smp.h"
+#include <stdio.h>
+
+static void (*cpu1_entry)(void) = 0;
+static volatile u32 cpu1_running = 0;
+
+#ifdef PVZ_HOST_THREADS
+
+/* ============================================================ */
+/*                   HOST (PTHREAD) BUILD                       */
+/* ============================================================ */
+#include <pthread.h>
+
+static pthread_t cpu1_thread;
+static pthread_mutex_t event_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t event_cond = PTHREAD_COND_INITIALIZER;
+static int event_pending[SMP_NUM_CORES];
+
+// The thread that called smp_start_cpu1 plays CPU0
+static __thread int core_id = 0;
+
+static void *cpu1_thread_main(void *arg)
+{
+    (void)arg;
+    core_id = 1;
+    __atomic_store_n(&cpu1_running, 1, __ATOMIC_RELEASE);
+    cpu1_entry();
+    return NULL;
+}
+
+int smp_start_cpu1(void (*entry)(void))
+{
+    cpu1_entry = entry;
+    if (pthread_create(&cpu1_thread, NULL, cpu1_thread_main, NULL) != 0) {
+        printf("WARNING: could not start the render thread\n");
+        return -1;
+    }
+    return 0;
+}
+
+int smp_core_id(void)
+{
+    return core_id;
+}
+
+// Event register semantics: one pending event per core, consumed by its next wait
+void smp_signal(void)
+{
+    pthread_mutex_lock(&event_lock);
+    event_pending[!core_id] = 1;
+    pthread_cond_broadcast(&event_cond);
+    pthread_mutex_unlock(&event_lock);
+}
+
+void smp_wait(void)
+{
+    pthread_mutex_lock(&event_lock);
+    while (!event_pending[core_id])
+        pthread_cond_wait(&event_cond, &event_lock);
+    event_pending[core_id] = 0;
+    pthread_mutex_unlock(&event_lock);
+}
+
+void smp_join_cpu1(void)
+{
+    pthread_join(cpu1_thread, NULL);
+}
+
+#else
+
+/* ============================================================ */
+/*                      BOARD BUILD                             */
+/* ============================================================ */
+#include "xil_io.h"
+#include "xil_cache.h"
+#include "xpseudo_asm.h"
+
+// Snoop Control Unit: keeps the two L1 data caches coherent
+#define SCU_CONTROL_ADDR     0xF8F00000
+#define SCU_ENABLE           0x1
+
+// CPU0's system registers, read by the trampoline with CPU1's MMU and
+// caches still off (so flushed to DDR before the wake-up)
+typedef struct {
+    u32 ttbr0;          // +0
+    u32 dacr;           // +4
+    u32 sctlr;          // +8
+    u32 vbar;           // +12
+    u32 cpacr;          // +16
+    u32 actlr;          // +20
+    u32 stack_top;      // +24
+    u32 entry;          // +28
+} SmpBoot;
+
+SmpBoot smp_boot __attribute__((aligned(32)));
+
+static u8 cpu1_stack[SMP_CPU1_STACK_BYTES] __attribute__((aligned(8)));
+
+void smp_cpu1_trampoline(void);
+
+/*
+ * CPU1 reset path: join the coherency domain, invalidate its own L1
+ * and TLBs (their contents are undefined after reset), then switch on
+ * the MMU with CPU0's table and jump to C on its own stack.
+ */
+__asm__(
+    "    .text\n"
+    "    .arm\n"
+    "    .fpu    vfpv3\n"
+    "    .align  5\n"
+    "    .global smp_cpu1_trampoline\n"
+    "    .type   smp_cpu1_trampoline, %function\n"
+    "smp_cpu1_trampoline:\n"
+    "    cpsid   aif\n"
+    "    ldr     r4, =smp_boot\n"
+    // SMP (coherency) and FW (maintenance broadcast) as on CPU0
+    "    ldr     r0, [r4, #20]\n"
+    "    mcr     p15, 0, r0, c1, c0, 1\n"
+    // TLBs, I-cache, branch predictor
+    "    mov     r0, #0\n"
+    "    mcr     p15, 0, r0, c8, c7, 0\n"
+    "    mcr     p15, 0, r0, c7, c5, 0\n"
+    "    mcr     p15, 0, r0, c7, c5, 6\n"
+    // L1 D-cache by set/way: 4 ways x 256 sets of 32-byte lines
+    "    mov     r1, #0\n"
+    "1:  mov     r2, #0\n"
+    "2:  mov     r3, r2, lsl #30\n"
+    "    orr     r3, r3, r1, lsl #5\n"
+    "    mcr     p15, 0, r3, c7, c6, 2\n"
+    "    add     r2, r2, #1\n"
+    "    cmp     r2, #4\n"
+    "    blt     2b\n"
+    "    add     r1, r1, #1\n"
+    "    cmp     r1, #256\n"
+    "    blt     1b\n"
+    "    dsb\n"
+    // CPU0's translation table, domains and vector base
+    "    ldr     r0, [r4, #0]\n"
+    "    mcr     p15, 0, r0, c2, c0, 0\n"
+    "    ldr     r0, [r4, #4]\n"
+    "    mcr     p15, 0, r0, c3, c0, 0\n"
+    "    ldr     r0, [r4, #12]\n"
+    "    mcr     p15, 0, r0, c12, c0, 0\n"
+    // VFP/NEON: the pixel kernels and the game use both
+    "    ldr     r0, [r4, #16]\n"
+    "    mcr     p15, 0, r0, c1, c0, 2\n"
+    "    isb\n"
+    "    mov     r0, #0x40000000\n"
+    "    vmsr    fpexc, r0\n"
+    // MMU, caches and branch prediction as on CPU0
+    "    ldr     r0, [r4, #8]\n"
+    "    dsb\n"
+    "    mcr     p15, 0, r0, c1, c0, 0\n"
+    "    isb\n"
+    "    ldr     sp, [r4, #24]\n"
+    "    ldr     r0, [r4, #28]\n"
+    "    blx     r0\n"
+    "3:  wfe\n"
+    "    b       3b\n"
+    "    .ltorg\n"
+);
+
+#define CP15_READ(var, crn, crm, op2) \
+    __asm__ volatile("mrc p15, 0, %0, " #crn ", " #crm ", " #op2 : "=r"(var))
+
+/**
+ * First C code on CPU1
+ */
+static void cpu1_main(void)
+{
+    cpu1_running = 1;
+    dsb();
+    cpu1_entry();
+
+    // entry() is not expected to return; park the core
+    while (1)
+        __asm__ volatile("wfe");
+}
+
+/**
+ * Start entry() on CPU1
+ */
+int smp_start_cpu1(void (*entry)(void))
+{
+    u32 timeout;
+
+    cpu1_entry = entry;
+
+    CP15_READ(smp_boot.ttbr0, c2, c0, 0);
+    CP15_READ(smp_boot.dacr, c3, c0, 0);
+    CP15_READ(smp_boot.sctlr, c1, c0, 0);
+    CP15_READ(smp_boot.vbar, c12, c0, 0);
+    CP15_READ(smp_boot.cpacr, c1, c0, 2);
+    CP15_READ(smp_boot.actlr, c1, c0, 1);
+    smp_boot.stack_top = (u32)(UINTPTR)(cpu1_stack + sizeof(cpu1_stack));
+    smp_boot.entry = (u32)(UINTPTR)cpu1_main;
+
+    Xil_Out32(SCU_CONTROL_ADDR, Xil_In32(SCU_CONTROL_ADDR) | SCU_ENABLE);
+
+    // CPU1 starts uncached: everything it reads has to be in DDR
+    Xil_DCacheFlush();
+
+    Xil_Out32(SMP_CPU1_START_ADDR, (u32)(UINTPTR)smp_cpu1_trampoline);
+    Xil_DCacheFlushRange(SMP_CPU1_START_ADDR & ~31u, 32);
+    dsb();
+    __asm__ volatile("sev");
+
+    for (timeout = 0; timeout < 100000000; timeout++) {
+        if (cpu1_running) {
+            printf("INFO: CPU1 started\n");
+            return 0;
+        }
+    }
+
+    printf("WARNING: CPU1 did not start\n");
+    return -1;
+}
+
+int smp_core_id(void)
+{
+    u32 mpidr;
+
+    CP15_READ(mpidr, c0, c0, 5);
+    return mpidr & 0x3;
+}
+
+void smp_signal(void)
+{
+    dsb();
+    __asm__ volatile("sev");
+}
+
+void smp_wait(void)
+{
+    __asm__ volatile("wfe");
+}
+
+#endif // PVZ_HOST_THREADS
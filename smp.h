@@ -0,0 +1,50 @@
+/* ------------------------------------------------------------ */
+/*             Second Core Start-up (Zynq CPU1)                 */
+/* ------------------------------------------------------------ */
+#ifndef SMP_H
+#define SMP_H
+
+#include "xil_types.h"
+
+/* Boot ROM parks CPU1 in WFE and jumps to the address stored here */
+#define SMP_CPU1_START_ADDR  0xFFFFFFF0
+
+/* Cores in the Zynq-7000 application processor */
+#define SMP_NUM_CORES        2
+
+/* Stack for code running on CPU1 */
+#ifndef SMP_CPU1_STACK_BYTES
+#define SMP_CPU1_STACK_BYTES (64 * 1024)
+#endif
+
+/*
+ * On the board CPU1 runs entry() with the same translation table,
+ * vectors and cache settings as CPU0, interrupts masked. It takes no
+ * interrupts: it sleeps in smp_wait() until smp_signal() from CPU0.
+ *
+ * Built with PVZ_HOST_THREADS the same calls map onto a pthread, so
+ * the two-core design can run (and be checked with ThreadSanitizer)
+ * on a PC.
+ */
+
+/**
+ * Start entry() on the second core
+ * Returns 0 once it is running, -1 if it did not come up.
+ */
+int smp_start_cpu1(void (*entry)(void));
+
+/* Index of the calling core: 0 or 1 */
+int smp_core_id(void);
+
+/* Wake the other core from smp_wait (SEV) */
+void smp_signal(void);
+
+/* Sleep until smp_signal or an interrupt (WFE); may return spuriously */
+void smp_wait(void);
+
+#ifdef PVZ_HOST_THREADS
+/* Host only: wait for entry() to return */
+void smp_join_cpu1(void);
+#endif
+
+#endif // SMP_H
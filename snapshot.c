@@ -0,0 +1,54 @@
+/* ------------------------------------------------------------ */
+/*          Game State Snapshots (Lock-Free Triple Buffer)      */
+/* ------------------------------------------------------------ */
+#include "snapshot.h"
+#include <string.h>
+
+/**
+ * Fill every slot with the initial state
+ */
+void snapshot_init(SnapshotBuffer *sb, const GameState *initial)
+{
+    int i;
+
+    for (i = 0; i < 3; i++)
+        memcpy(&sb->slots[i], initial, sizeof(GameState));
+
+    sb->write_index = 0;
+    sb->shared = 1;
+    sb->read_index = 2;
+    sb->published = 0;
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+/**
+ * Writer: fill the private slot, then swap it with the shared one
+ * Release ordering makes the copy visible before the index is.
+ */
+void snapshot_publish(SnapshotBuffer *sb, const GameState *game)
+{
+    u32 old;
+
+    memcpy(&sb->slots[sb->write_index], game, sizeof(GameState));
+
+    old = __atomic_exchange_n(&sb->shared, sb->write_index | SNAPSHOT_FRESH, __ATOMIC_ACQ_REL);
+    sb->write_index = old & SNAPSHOT_INDEX_MASK;
+    sb->published++;
+}
+
+/**
+ * Reader: swap the private slot with the shared one if it holds
+ * something newer
+ */
+GameState *snapshot_acquire(SnapshotBuffer *sb)
+{
+    u32 old;
+
+    if (!(__atomic_load_n(&sb->shared, __ATOMIC_ACQUIRE) & SNAPSHOT_FRESH))
+        return NULL;
+
+    // Only the reader clears FRESH, so the shared slot is still newer than ours
+    old = __atomic_exchange_n(&sb->shared, sb->read_index, __ATOMIC_ACQ_REL);
+    sb->read_index = old & SNAPSHOT_INDEX_MASK;
+    return &sb->slots[sb->read_index];
+}
@@ -0,0 +1,48 @@
+/* ------------------------------------------------------------ */
+/*          Game State Snapshots (Lock-Free Triple Buffer)      */
+/* ------------------------------------------------------------ */
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "xil_types.h"
+#include "pvz_game.h"
+
+/*
+ * One writer (simulation) and one reader (renderer) exchange whole
+ * GameState copies through three slots: the writer's, the reader's and
+ * a shared one. Publishing and acquiring each swap a slot with the
+ * shared one in a single atomic exchange, so neither side ever waits
+ * and the reader always gets the newest complete state.
+ */
+
+/* Bits of SnapshotBuffer.shared */
+#define SNAPSHOT_INDEX_MASK  0x3    /* slot currently shared */
+#define SNAPSHOT_FRESH       0x4    /* set by publish, cleared by acquire */
+
+typedef struct {
+    GameState slots[3];
+    /* Each side's fields sit in their own cache line */
+    u32 shared __attribute__((aligned(32)));
+    u8 write_index __attribute__((aligned(32)));   /* writer only */
+    u32 published;                                 /* writer only */
+    u8 read_index __attribute__((aligned(32)));    /* reader only */
+} SnapshotBuffer;
+
+/**
+ * Fill every slot with the initial state (before the reader starts)
+ */
+void snapshot_init(SnapshotBuffer *sb, const GameState *initial);
+
+/**
+ * Writer: copy the state into the private slot and make it the newest
+ */
+void snapshot_publish(SnapshotBuffer *sb, const GameState *game);
+
+/**
+ * Reader: take the newest snapshot if one was published since the last
+ * call, else NULL. The returned slot stays the reader's (and unchanged)
+ * until the next successful acquire.
+ */
+GameState *snapshot_acquire(SnapshotBuffer *sb);
+
+#endif // SNAPSHOT_H
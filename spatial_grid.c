@@ -0,0 +1,120 @@
+/* ------------------------------------------------------------ */
+/*            Spatial Grid (Uniform Bucket Index)               */
+/* ------------------------------------------------------------ */
+#include "spatial_grid.h"
+
+/**
+ * Bucket column and row of a point, clamped to the grid
+ */
+static int bucket_col(int x)
+{
+    int col = (x < 0) ? 0 : x / SGRID_CELL_W;
+
+    return (col < SGRID_COLS) ? col : SGRID_COLS - 1;
+}
+
+static int bucket_row(int y)
+{
+    int row = (y < 0) ? 0 : y / SGRID_CELL_H;
+
+    return (row < SGRID_ROWS) ? row : SGRID_ROWS - 1;
+}
+
+static void unlink_item(SpatialBuckets *buckets, SpatialItem *items, int id)
+{
+    SpatialItem *item = &items[id];
+
+    if (item->prev != SGRID_NONE)
+        items[item->prev].next = item->next;
+    else
+        buckets->head[item->bucket] = item->next;
+    if (item->next != SGRID_NONE)
+        items[item->next].prev = item->prev;
+}
+
+static void link_item(SpatialBuckets *buckets, SpatialItem *items, int id, int bucket)
+{
+    SpatialItem *item = &items[id];
+
+    item->bucket = bucket;
+    item->prev = SGRID_NONE;
+    item->next = buckets->head[bucket];
+    if (item->next != SGRID_NONE)
+        items[item->next].prev = id;
+    buckets->head[bucket] = id;
+}
+
+void sgrid_init(SpatialBuckets *buckets, SpatialItem *items, int capacity)
+{
+    int i;
+
+    for (i = 0; i < SGRID_ROWS * SGRID_COLS; i++)
+        buckets->head[i] = SGRID_NONE;
+    buckets->max_w = 0;
+    buckets->max_h = 0;
+
+    for (i = 0; i < capacity; i++)
+        items[i].bucket = SGRID_NONE;
+}
+
+/**
+ * Relink only when the top-left corner changes bucket
+ */
+void sgrid_place(SpatialBuckets *buckets, SpatialItem *items, int id, int x, int y, int w, int h)
+{
+    SpatialItem *item = &items[id];
+    int bucket = bucket_row(y) * SGRID_COLS + bucket_col(x);
+
+    if (item->bucket != bucket) {
+        if (item->bucket != SGRID_NONE)
+            unlink_item(buckets, items, id);
+        link_item(buckets, items, id, bucket);
+    }
+
+    item->x = x;
+    item->y = y;
+    item->w = w;
+    item->h = h;
+    if (w > buckets->max_w) buckets->max_w = w;
+    if (h > buckets->max_h) buckets->max_h = h;
+}
+
+void sgrid_remove(SpatialBuckets *buckets, SpatialItem *items, int id)
+{
+    if (items[id].bucket == SGRID_NONE)
+        return;
+
+    unlink_item(buckets, items, id);
+    items[id].bucket = SGRID_NONE;
+}
+
+/**
+ * An item reaching into the rectangle has its corner at most max_w left
+ * of it and max_h above it: those buckets, and the ones under the
+ * rectangle, hold every candidate.
+ */
+void sgrid_query(const SpatialBuckets *buckets, const SpatialItem *items, int x, int y, int w, int h,
+                 void (*visit)(int id, void *arg), void *arg)
+{
+    int col0, col1, row0, row1, row, col, id;
+
+    if (w <= 0 || h <= 0)
+        return;
+
+    col0 = bucket_col(x - buckets->max_w);
+    col1 = bucket_col(x + w - 1);
+    row0 = bucket_row(y - buckets->max_h);
+    row1 = bucket_row(y + h - 1);
+
+    for (row = row0; row <= row1; row++) {
+        for (col = col0; col <= col1; col++) {
+            for (id = buckets->head[row * SGRID_COLS + col]; id != SGRID_NONE; id = items[id].next) {
+                const SpatialItem *item = &items[id];
+
+                if (item->x < x + w && x < item->x + item->w &&
+                    item->y < y + h && y < item->y + item->h)
+                    visit(id, arg);
+            }
+        }
+    }
+}
@@ -0,0 +1,84 @@
+/* ------------------------------------------------------------ */
+/*            Spatial Grid (Uniform Bucket Index)               */
+/* ------------------------------------------------------------ */
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include "xil_types.h"
+
+/*
+ * A loose uniform grid over the screen answering "which items overlap
+ * this rectangle". Items are small integer ids; each registers its
+ * screen bounds and sits in the one bucket holding its top-left corner,
+ * on a list threaded through the item array. Moving an item within its
+ * bucket only rewrites its bounds, and crossing into another bucket is
+ * one unlink and one link, so updates cost O(1) however many items
+ * there are.
+ *
+ * Because an item is listed only under its corner, a query visits the
+ * buckets under the rectangle extended up and left by the largest
+ * bounds ever registered, then tests each item found exactly.
+ *
+ * Items off screen fall into the nearest edge bucket. The grid holds no
+ * pointers and can be copied with the state it indexes.
+ */
+
+/* Bucket size in pixels */
+#ifndef SGRID_CELL_W
+#define SGRID_CELL_W   50
+#endif
+#ifndef SGRID_CELL_H
+#define SGRID_CELL_H   40
+#endif
+#define SGRID_COLS     ((800 + SGRID_CELL_W - 1) / SGRID_CELL_W)   /* 16 */
+#define SGRID_ROWS     ((480 + SGRID_CELL_H - 1) / SGRID_CELL_H)   /* 12 */
+
+/* End of a bucket list; bucket of an item not registered */
+#define SGRID_NONE     0xFFFF
+
+/* Bucket list heads and the largest bounds registered since init */
+typedef struct {
+    u16 head[SGRID_ROWS * SGRID_COLS];
+    s16 max_w, max_h;
+} SpatialBuckets;
+
+/* One item: its bounds, its bucket and its neighbours there */
+typedef struct {
+    s16 x, y, w, h;
+    u16 bucket;
+    u16 prev, next;
+} SpatialItem;
+
+/* Grid for item ids 0..cap-1 (cap < 65535) */
+#define SPATIAL_GRID(cap)  struct { SpatialBuckets buckets; SpatialItem items[cap]; }
+
+#define SGRID_CAPACITY(g)  ((int)(sizeof((g)->items) / sizeof((g)->items[0])))
+
+/* Empty grid, no item registered */
+#define SGRID_INIT(g)      sgrid_init(&(g)->buckets, (g)->items, SGRID_CAPACITY(g))
+
+/* Register an item's bounds, or move it to new ones */
+#define SGRID_PLACE(g, id, x, y, w, h) \
+    sgrid_place(&(g)->buckets, (g)->items, (id), (x), (y), (w), (h))
+
+/* Nonzero if the item is registered with exactly these bounds, so
+ * placing it again would change nothing */
+#define SGRID_UNCHANGED(g, id, bx, by, bw, bh) \
+    ((g)->items[id].bucket != SGRID_NONE && \
+     (g)->items[id].x == (bx) && (g)->items[id].y == (by) && \
+     (g)->items[id].w == (bw) && (g)->items[id].h == (bh))
+
+/* Drop an item (no-op if not registered) */
+#define SGRID_REMOVE(g, id)  sgrid_remove(&(g)->buckets, (g)->items, (id))
+
+/* Call visit(id, arg) for every item whose bounds overlap the rectangle */
+#define SGRID_QUERY(g, x, y, w, h, visit, arg) \
+    sgrid_query(&(g)->buckets, (g)->items, (x), (y), (w), (h), (visit), (arg))
+
+void sgrid_init(SpatialBuckets *buckets, SpatialItem *items, int capacity);
+void sgrid_place(SpatialBuckets *buckets, SpatialItem *items, int id, int x, int y, int w, int h);
+void sgrid_remove(SpatialBuckets *buckets, SpatialItem *items, int id);
+void sgrid_query(const SpatialBuckets *buckets, const SpatialItem *items, int x, int y, int w, int h,
+                 void (*visit)(int id, void *arg), void *arg);
+
+#endif // SPATIAL_GRID_H
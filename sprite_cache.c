@@ -0,0 +1,308 @@
+/* ------------------------------------------------------------ */
+/*                Pre-scaled Sprite Frame Cache                 */
+/* ------------------------------------------------------------ */
+#include "sprite_cache.h"
+#include "scale_table.h"
+#include <stdio.h>
+
+// Sheets live in pvz_game.c (image headers can only be included once)
+extern const unsigned char gImage_PeaShooter_ani[];
+extern const unsigned char gImage_SunFlower_ani[];
+extern const unsigned char gImage_walk_ani[];
+extern const unsigned char gImage_bite_ani[];
+extern const unsigned char gImage_Sun[];
+extern const unsigned char gImage_ProjectilePea[];
+extern const unsigned char gImage_SunBank[];
+extern const unsigned char gImage_SeedBank[];
+
+static SpriteCacheMode cache_mode = SPRITE_CACHE_OFF;
+
+// Pre-scaled frames, one slot per frame of each sheet
+static u8 peashooter_frames[PLANT_SHEET_FRAMES][PLANT_FRAME_BYTES];
+static u8 sunflower_frames[PLANT_SHEET_FRAMES][PLANT_FRAME_BYTES];
+static u8 walk_frames[WALK_SHEET_FRAMES][ZOMBIE_FRAME_BYTES];
+static u8 bite_frames[BITE_SHEET_FRAMES][ZOMBIE_FRAME_BYTES];
+
+// 1 = slot holds the scaled frame
+static u8 peashooter_ready[PLANT_SHEET_FRAMES];
+static u8 sunflower_ready[PLANT_SHEET_FRAMES];
+static u8 walk_ready[WALK_SHEET_FRAMES];
+static u8 bite_ready[BITE_SHEET_FRAMES];
+
+static u32 bytes_filled = 0;
+
+// RLE encodings of the scaled frames, built as each frame is filled
+static RleSprite peashooter_rle[PLANT_SHEET_FRAMES];
+static RleSprite sunflower_rle[PLANT_SHEET_FRAMES];
+static RleSprite walk_rle[WALK_SHEET_FRAMES];
+static RleSprite bite_rle[BITE_SHEET_FRAMES];
+
+// Static transparent sprites drawn through draw_sprite_transparent
+#define NUM_STATIC_RLE  4
+static struct {
+    const u8 *pixels;
+    int w, h;
+    RleSprite rle;
+} static_rle[NUM_STATIC_RLE];
+
+static int rle_enabled = 1;
+
+/**
+ * Scale one 80x80 plant frame to PLANT_SIZE
+ * Same source mapping as the scaling path of draw_sprite_from_sheet.
+ */
+static void scale_plant_frame(u8 *dst, const u8 *sheet_data, int frame_index)
+{
+    int i, j;
+    int src_x_offset = (frame_index % SPRITE_COLS) * FRAME_SIZE;
+    int src_y_offset = (frame_index / SPRITE_COLS) * FRAME_SIZE;
+
+    const ScaleTable *t = scale_table_get(FRAME_SIZE, PLANT_SIZE, PLANT_SIZE);
+
+    for (i = 0; i < PLANT_SIZE; i++) {
+        int src_y = src_y_offset + t->index[i];
+
+        for (j = 0; j < PLANT_SIZE; j++) {
+            int src_x = src_x_offset + t->index[j];
+            u32 sheet_idx = (src_y * SPRITE_SHEET_SIZE + src_x) * 3;
+
+            dst[0] = sheet_data[sheet_idx];
+            dst[1] = sheet_data[sheet_idx + 1];
+            dst[2] = sheet_data[sheet_idx + 2];
+            dst += 3;
+        }
+    }
+}
+
+/**
+ * Scale one zombie frame by ZOMBIE_SCALE
+ * Same source mapping as draw_zombie_sprite / draw_bite_sprite.
+ */
+static void scale_zombie_frame(u8 *dst, const u8 *sheet_data, int sheet_width,
+                               int src_x, int src_y, int frame_w, int frame_h)
+{
+    int i, j;
+    // Inverse scaling by ZOMBIE_SCALE; one table serves both axes (same ratio)
+    const ScaleTable *zoom = scale_table_get(100, ZOMBIE_SCALE_PERCENT, ZOMBIE_DISPLAY_HEIGHT);
+
+    for (i = 0; i < ZOMBIE_DISPLAY_HEIGHT; i++) {
+        int src_i = zoom->index[i];
+        if (src_i >= frame_h)
+            src_i = frame_h - 1;
+
+        for (j = 0; j < ZOMBIE_DISPLAY_WIDTH; j++) {
+            int src_j = zoom->index[j];
+            if (src_j >= frame_w)
+                src_j = frame_w - 1;
+
+            u32 sheet_idx = ((src_y + src_i) * sheet_width + (src_x + src_j)) * 3;
+
+            dst[0] = sheet_data[sheet_idx];
+            dst[1] = sheet_data[sheet_idx + 1];
+            dst[2] = sheet_data[sheet_idx + 2];
+            dst += 3;
+        }
+    }
+}
+
+static void fill_walk_frame(int frame_index)
+{
+    scale_zombie_frame(walk_frames[frame_index], gImage_walk_ani, ZOMBIE_SHEET_WIDTH,
+                       (frame_index % ZOMBIE_COLS) * ZOMBIE_WIDTH,
+                       (frame_index / ZOMBIE_COLS) * ZOMBIE_HEIGHT,
+                       ZOMBIE_WIDTH, ZOMBIE_HEIGHT);
+    rle_encode(&walk_rle[frame_index], walk_frames[frame_index],
+               ZOMBIE_DISPLAY_WIDTH, ZOMBIE_DISPLAY_HEIGHT, RLE_KEY_BLACK);
+    walk_ready[frame_index] = 1;
+    bytes_filled += ZOMBIE_FRAME_BYTES;
+}
+
+static void fill_bite_frame(int frame_index)
+{
+    scale_zombie_frame(bite_frames[frame_index], gImage_bite_ani, BITE_SHEET_WIDTH,
+                       (frame_index % BITE_COLS) * BITE_FRAME_WIDTH,
+                       (frame_index / BITE_COLS) * BITE_FRAME_HEIGHT,
+                       BITE_FRAME_WIDTH, BITE_FRAME_HEIGHT);
+    rle_encode(&bite_rle[frame_index], bite_frames[frame_index],
+               ZOMBIE_DISPLAY_WIDTH, ZOMBIE_DISPLAY_HEIGHT, RLE_KEY_BLACK);
+    bite_ready[frame_index] = 1;
+    bytes_filled += ZOMBIE_FRAME_BYTES;
+}
+
+void sprite_cache_init(SpriteCacheMode mode)
+{
+    int i;
+
+    cache_mode = mode;
+    bytes_filled = 0;
+    rle_pool_reset();
+
+    for (i = 0; i < PLANT_SHEET_FRAMES; i++) {
+        peashooter_ready[i] = 0;
+        sunflower_ready[i] = 0;
+    }
+    for (i = 0; i < WALK_SHEET_FRAMES; i++)
+        walk_ready[i] = 0;
+    for (i = 0; i < BITE_SHEET_FRAMES; i++)
+        bite_ready[i] = 0;
+
+    if (mode == SPRITE_CACHE_OFF)
+        return;
+
+    // Static sprites are small - always encode them up front
+    static_rle[0].pixels = gImage_Sun;
+    static_rle[0].w = SUN_SIZE;
+    static_rle[0].h = SUN_SIZE;
+    static_rle[1].pixels = gImage_ProjectilePea;
+    static_rle[1].w = PEA_SIZE;
+    static_rle[1].h = PEA_SIZE;
+    static_rle[2].pixels = gImage_SunBank;
+    static_rle[2].w = 63;
+    static_rle[2].h = 70;
+    static_rle[3].pixels = gImage_SeedBank;
+    static_rle[3].w = SEEDBANK_DRAW_WIDTH;
+    static_rle[3].h = SEEDBANK_DRAW_HEIGHT;
+
+    for (i = 0; i < NUM_STATIC_RLE; i++) {
+        rle_encode(&static_rle[i].rle, static_rle[i].pixels,
+                   static_rle[i].w, static_rle[i].h, RLE_KEY_NEAR_BLACK);
+    }
+
+    if (mode != SPRITE_CACHE_EAGER)
+        return;
+
+    for (i = 0; i < PLANT_SHEET_FRAMES; i++) {
+        sprite_cache_plant(gImage_PeaShooter_ani, i);
+        sprite_cache_plant(gImage_SunFlower_ani, i);
+    }
+    for (i = 0; i < WALK_SHEET_FRAMES; i++)
+        fill_walk_frame(i);
+    for (i = 0; i < BITE_SHEET_FRAMES; i++)
+        fill_bite_frame(i);
+}
+
+const u8 *sprite_cache_plant(const u8 *sheet_data, int frame_index)
+{
+    u8 (*frames)[PLANT_FRAME_BYTES];
+    u8 *ready;
+    RleSprite *rle;
+
+    if (cache_mode == SPRITE_CACHE_OFF || frame_index < 0 || frame_index >= PLANT_SHEET_FRAMES)
+        return NULL;
+
+    if (sheet_data == gImage_PeaShooter_ani) {
+        frames = peashooter_frames;
+        ready = peashooter_ready;
+        rle = peashooter_rle;
+    }
+    else if (sheet_data == gImage_SunFlower_ani) {
+        frames = sunflower_frames;
+        ready = sunflower_ready;
+        rle = sunflower_rle;
+    }
+    else {
+        return NULL;
+    }
+
+    if (!ready[frame_index]) {
+        scale_plant_frame(frames[frame_index], sheet_data, frame_index);
+        rle_encode(&rle[frame_index], frames[frame_index], PLANT_SIZE, PLANT_SIZE, RLE_KEY_BLACK);
+        ready[frame_index] = 1;
+        bytes_filled += PLANT_FRAME_BYTES;
+    }
+    return frames[frame_index];
+}
+
+const u8 *sprite_cache_walk(int frame_index)
+{
+    if (cache_mode == SPRITE_CACHE_OFF || frame_index < 0 || frame_index >= WALK_SHEET_FRAMES)
+        return NULL;
+
+    if (!walk_ready[frame_index])
+        fill_walk_frame(frame_index);
+    return walk_frames[frame_index];
+}
+
+const u8 *sprite_cache_bite(int frame_index)
+{
+    if (cache_mode == SPRITE_CACHE_OFF || frame_index < 0 || frame_index >= BITE_SHEET_FRAMES)
+        return NULL;
+
+    if (!bite_ready[frame_index])
+        fill_bite_frame(frame_index);
+    return bite_frames[frame_index];
+}
+
+const RleSprite *sprite_cache_plant_rle(const u8 *sheet_data, int frame_index)
+{
+    const RleSprite *rle;
+
+    if (!rle_enabled || !sprite_cache_plant(sheet_data, frame_index))
+        return NULL;
+
+    rle = (sheet_data == gImage_PeaShooter_ani) ? &peashooter_rle[frame_index]
+                                                : &sunflower_rle[frame_index];
+    return rle->data ? rle : NULL;
+}
+
+const RleSprite *sprite_cache_walk_rle(int frame_index)
+{
+    if (!rle_enabled || !sprite_cache_walk(frame_index))
+        return NULL;
+
+    return walk_rle[frame_index].data ? &walk_rle[frame_index] : NULL;
+}
+
+const RleSprite *sprite_cache_bite_rle(int frame_index)
+{
+    if (!rle_enabled || !sprite_cache_bite(frame_index))
+        return NULL;
+
+    return bite_rle[frame_index].data ? &bite_rle[frame_index] : NULL;
+}
+
+const RleSprite *sprite_cache_static_rle(const u8 *sprite_data, int w, int h)
+{
+    int i;
+
+    if (!rle_enabled || cache_mode == SPRITE_CACHE_OFF)
+        return NULL;
+
+    for (i = 0; i < NUM_STATIC_RLE; i++) {
+        if (static_rle[i].pixels == sprite_data && static_rle[i].w == w && static_rle[i].h == h)
+            return static_rle[i].rle.data ? &static_rle[i].rle : NULL;
+    }
+    return NULL;
+}
+
+void sprite_cache_set_rle(int enable)
+{
+    rle_enabled = enable;
+}
+
+u32 sprite_cache_bytes_reserved(void)
+{
+    return sizeof(peashooter_frames) + sizeof(sunflower_frames) +
+           sizeof(walk_frames) + sizeof(bite_frames);
+}
+
+u32 sprite_cache_bytes_filled(void)
+{
+    return bytes_filled;
+}
+
+void sprite_cache_report(void)
+{
+    static const char *mode_names[] = { "off", "eager", "lazy" };
+
+    printf("INFO: Sprite cache (%s)\n", mode_names[cache_mode]);
+    printf("  plants  %2d x 2 frames @ %dx%d  %7u bytes\n", PLANT_SHEET_FRAMES,
+           PLANT_SIZE, PLANT_SIZE, (unsigned)(sizeof(peashooter_frames) + sizeof(sunflower_frames)));
+    printf("  walk    %2d frames @ %dx%d      %7u bytes\n", WALK_SHEET_FRAMES,
+           ZOMBIE_DISPLAY_WIDTH, ZOMBIE_DISPLAY_HEIGHT, (unsigned)sizeof(walk_frames));
+    printf("  bite    %2d frames @ %dx%d      %7u bytes\n", BITE_SHEET_FRAMES,
+           ZOMBIE_DISPLAY_WIDTH, ZOMBIE_DISPLAY_HEIGHT, (unsigned)sizeof(bite_frames));
+    printf("  reserved %u bytes, filled %u bytes\n",
+           (unsigned)sprite_cache_bytes_reserved(), (unsigned)bytes_filled);
+    printf("  RLE pool %u / %u bytes\n", (unsigned)rle_pool_used(), (unsigned)RLE_POOL_BYTES);
+}
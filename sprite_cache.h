@@ -0,0 +1,62 @@
+/* ------------------------------------------------------------ */
+/*                Pre-scaled Sprite Frame Cache                 */
+/* ------------------------------------------------------------ */
+#ifndef SPRITE_CACHE_H
+#define SPRITE_CACHE_H
+
+#include "xil_types.h"
+#include "pvz_game.h"
+#include "rle_sprite.h"
+
+/* Frame counts of the cached sheets */
+#define PLANT_SHEET_FRAMES   ANIMATION_FRAMES
+#define WALK_SHEET_FRAMES    (ZOMBIE_ROWS * ZOMBIE_COLS)
+#define BITE_SHEET_FRAMES    (BITE_ROWS * BITE_COLS)
+
+/* Bytes per cached frame (display size, RGB888, black = transparent) */
+#define PLANT_FRAME_BYTES    (PLANT_SIZE * PLANT_SIZE * 3)
+#define ZOMBIE_FRAME_BYTES   (ZOMBIE_DISPLAY_WIDTH * ZOMBIE_DISPLAY_HEIGHT * 3)
+
+typedef enum {
+    SPRITE_CACHE_OFF = 0,       /* always scale from the sheet */
+    SPRITE_CACHE_EAGER = 1,     /* scale every frame at init */
+    SPRITE_CACHE_LAZY = 2       /* scale each frame the first time it is drawn */
+} SpriteCacheMode;
+
+/**
+ * Set the cache mode; EAGER scales all frames before returning
+ */
+void sprite_cache_init(SpriteCacheMode mode);
+
+/**
+ * Get a pre-scaled plant frame (PLANT_SIZE x PLANT_SIZE)
+ * Returns NULL if the cache is off or sheet_data is not a plant sheet.
+ */
+const u8 *sprite_cache_plant(const u8 *sheet_data, int frame_index);
+
+/**
+ * Get a pre-scaled zombie frame (ZOMBIE_DISPLAY_WIDTH x ZOMBIE_DISPLAY_HEIGHT)
+ * Returns NULL if the cache is off or the frame is out of range.
+ */
+const u8 *sprite_cache_walk(int frame_index);
+const u8 *sprite_cache_bite(int frame_index);
+
+/**
+ * RLE-encoded versions of the cached frames and of the static
+ * transparent sprites (sun, pea, sun bank, seed bank)
+ * Return NULL if RLE is disabled or the sprite is not encoded.
+ */
+const RleSprite *sprite_cache_plant_rle(const u8 *sheet_data, int frame_index);
+const RleSprite *sprite_cache_walk_rle(int frame_index);
+const RleSprite *sprite_cache_bite_rle(int frame_index);
+const RleSprite *sprite_cache_static_rle(const u8 *sprite_data, int w, int h);
+
+/* Enable or bypass the RLE blitters (encodings are kept) */
+void sprite_cache_set_rle(int enable);
+
+/* Memory reserved by the cache, and the part of it filled so far */
+u32 sprite_cache_bytes_reserved(void);
+u32 sprite_cache_bytes_filled(void);
+void sprite_cache_report(void);
+
+#endif // SPRITE_CACHE_H
@@ -0,0 +1,439 @@
+/* ------------------------------------------------------------ */
+/*              Entity Update Benchmark (host)                  */
+/* ------------------------------------------------------------ */
+/*
+ * Fills each entity pool to capacity and times the per-tick movement
+ * (tick positions saved, position advanced, landing, lifetime or
+ * leaving the screen checked) in two layouts doing the same work: the
+ * arrays of structs the game keeps, and a structure of arrays written
+ * out here, one contiguous array per field, where the position update
+ * is one add over every slot handed out (free slots have zero
+ * velocity), NEON when the target has it. Both walk the game's pool
+ * for everything else, so only the layout differs.
+ *
+ * The peas' collision test is timed on its own with the zombie pool
+ * full as well: every pea against every zombie, as the game did before
+ * lanes, and game_check_pea_zombie_collision's sweep of the sorted
+ * lanes; no pea gets close enough to hit. Last, the game's whole update
+ * functions are timed, which also keep the lanes sorted and the spatial
+ * grid up to date.
+ *
+ * Host only: the board build compiles this file to nothing. Build with
+ * the BSP include directory on the path and capacities in the
+ * thousands:
+ *   gcc -O2 -DENTITY_BENCH_HOST -DPVZ_HOST_THREADS -DMAX_SUNS=1024 \
+ *       -DMAX_ZOMBIES=1024 -DMAX_PEAS=2048 -I<bsp>/include -I. \
+ *       tools/entity_bench.c pvz_game.c entity_pool.c spatial_grid.c display_list.c \
+ *       clip.c rle_sprite.c sprite_cache.c scale_table.c blit_kernels.c \
+ *       damage.c plant_tiles.c render_bands.c smp.c -o entity_bench -lpthread
+ * Add -mcpu=cortex-a9 -mfpu=neon -mfloat-abi=hard to build it for Linux
+ * on the Zynq, which times the NEON loop on the board's own core.
+ *
+ * Usage: entity_bench [repetitions]
+ * Each repetition restarts from the seeded state and runs BENCH_TICKS
+ * ticks, short enough that no entity lands, leaves or despawns.
+ */
+#ifdef ENTITY_BENCH_HOST
+
+#include "pvz_game.h"
+#include "blit_kernels.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if KERN_HAVE_NEON
+#include <arm_neon.h>
+#endif
+
+#define BENCH_TICKS    100
+
+// Cache maintenance used by damage.c: nothing to flush on the host
+void Xil_DCacheFlushRange(INTPTR adr, u32 len) { (void)adr; (void)len; }
+void Xil_DCacheFlush(void) { }
+
+int rects_overlap(int x1, int y1, int w1, int h1, int x2, int y2, int w2, int h2);
+
+// Too large for the stack with big capacities
+static GameState seeded_state;
+static GameState game;
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* ============================================================ */
+/*                  STRUCTURE OF ARRAYS                         */
+/* ============================================================ */
+
+/* Float arrays padded to whole 4-lane vectors */
+#define SOA_LANES(n)  (((n) + 3) & ~3)
+
+typedef struct {
+    float x[SOA_LANES(MAX_SUNS)], y[SOA_LANES(MAX_SUNS)];
+    float tick_x[SOA_LANES(MAX_SUNS)], tick_y[SOA_LANES(MAX_SUNS)];
+    float vx[SOA_LANES(MAX_SUNS)], vy[SOA_LANES(MAX_SUNS)];
+    float ay[SOA_LANES(MAX_SUNS)];              /* gravity while flying */
+    u16 lifetime[MAX_SUNS];
+    u8 landed[MAX_SUNS];
+} SoaSuns;
+
+typedef struct {
+    float x[SOA_LANES(MAX_ZOMBIES)], y[SOA_LANES(MAX_ZOMBIES)];
+    float tick_x[SOA_LANES(MAX_ZOMBIES)], tick_y[SOA_LANES(MAX_ZOMBIES)];
+    float vx[SOA_LANES(MAX_ZOMBIES)];           /* -ZOMBIE_SPEED while walking */
+    u8 state[MAX_ZOMBIES];
+    u8 animation_frame[MAX_ZOMBIES];
+} SoaZombies;
+
+typedef struct {
+    float x[SOA_LANES(MAX_PEAS)], y[SOA_LANES(MAX_PEAS)];
+    float tick_x[SOA_LANES(MAX_PEAS)], tick_y[SOA_LANES(MAX_PEAS)];
+    float vx[SOA_LANES(MAX_PEAS)];
+} SoaPeas;
+
+typedef struct {
+    SoaSuns suns;
+    SoaZombies zombies;
+    SoaPeas peas;
+    int sun_span, zombie_span, pea_span;    /* slots handed out */
+} SoaState;
+
+static SoaState soa, seeded_soa;
+
+/**
+ * dst[i] += src[i] over the first n slots, rounded up to whole vectors
+ */
+static void add_f32(float *dst, const float *src, int n)
+{
+    int i;
+
+    n = SOA_LANES(n);
+#if KERN_HAVE_NEON
+    for (i = 0; i < n; i += 4)
+        vst1q_f32(dst + i, vaddq_f32(vld1q_f32(dst + i), vld1q_f32(src + i)));
+#else
+    for (i = 0; i < n; i++)
+        dst[i] += src[i];
+#endif
+}
+
+static void soa_suns(GameState *g, int tick)
+{
+    SoaSuns *suns = &soa.suns;
+    int n, i;
+
+    (void)tick;
+    memcpy(suns->tick_x, suns->x, soa.sun_span * sizeof(float));
+    memcpy(suns->tick_y, suns->y, soa.sun_span * sizeof(float));
+    add_f32(suns->vy, suns->ay, soa.sun_span);
+    add_f32(suns->x, suns->vx, soa.sun_span);
+    add_f32(suns->y, suns->vy, soa.sun_span);
+
+    for (n = g->sun_pool.count - 1; n >= 0; n--) {
+        i = g->sun_pool.live[n];
+        if (!suns->landed[i] && suns->y[i] >= SUN_LANDING_HEIGHT) {
+            suns->y[i] = (float)SUN_LANDING_HEIGHT;
+            suns->vx[i] = suns->vy[i] = suns->ay[i] = 0.0f;
+            suns->landed[i] = 1;
+        }
+        if (--suns->lifetime[i] == 0) {
+            suns->vx[i] = suns->vy[i] = suns->ay[i] = 0.0f;
+            POOL_FREE(&g->sun_pool, i);
+        }
+    }
+}
+
+static void soa_zombies(GameState *g, int tick)
+{
+    SoaZombies *zombies = &soa.zombies;
+    int n, i;
+
+    memcpy(zombies->tick_x, zombies->x, soa.zombie_span * sizeof(float));
+    memcpy(zombies->tick_y, zombies->y, soa.zombie_span * sizeof(float));
+    add_f32(zombies->x, zombies->vx, soa.zombie_span);
+
+    for (n = g->zombie_pool.count - 1; n >= 0; n--) {
+        i = g->zombie_pool.live[n];
+        if (zombies->state[i] != ZOMBIE_WALKING)
+            continue;
+        if (tick % ZOMBIE_FRAMES_PER_UPDATE == 0 &&
+            ++zombies->animation_frame[i] >= ZOMBIE_ROWS * ZOMBIE_COLS)
+            zombies->animation_frame[i] = 0;
+        if (zombies->x[i] + ZOMBIE_DISPLAY_WIDTH < 0) {
+            zombies->vx[i] = 0.0f;
+            POOL_FREE(&g->zombie_pool, i);
+        }
+    }
+}
+
+static void soa_peas(GameState *g, int tick)
+{
+    SoaPeas *peas = &soa.peas;
+    int n, i;
+
+    (void)tick;
+    memcpy(peas->tick_x, peas->x, soa.pea_span * sizeof(float));
+    memcpy(peas->tick_y, peas->y, soa.pea_span * sizeof(float));
+    add_f32(peas->x, peas->vx, soa.pea_span);
+
+    for (n = g->pea_pool.count - 1; n >= 0; n--) {
+        i = g->pea_pool.live[n];
+        if (peas->x[i] > SCREEN_WIDTH) {
+            peas->vx[i] = 0.0f;
+            POOL_FREE(&g->pea_pool, i);
+        }
+    }
+}
+
+/* ============================================================ */
+/*                  ARRAY OF STRUCTS (GAME)                     */
+/* ============================================================ */
+
+/*
+ * The same movement over the game's own entity arrays, the way its
+ * update functions do it
+ */
+
+static void aos_suns(GameState *g, int tick)
+{
+    int n, i;
+
+    (void)tick;
+    game_begin_tick(g);
+    for (n = g->sun_pool.count - 1; n >= 0; n--) {
+        Sun *sun;
+
+        i = g->sun_pool.live[n];
+        sun = &g->suns[i];
+        if (!sun->landed) {
+            sun->vy += SUN_GRAVITY;
+            sun->x += sun->vx;
+            sun->y += sun->vy;
+            if (sun->y >= SUN_LANDING_HEIGHT) {
+                sun->y = (float)SUN_LANDING_HEIGHT;
+                sun->vx = sun->vy = 0.0f;
+                sun->landed = 1;
+            }
+        }
+        if (--sun->lifetime == 0)
+            POOL_FREE(&g->sun_pool, i);
+    }
+}
+
+static void aos_zombies(GameState *g, int tick)
+{
+    int n, i;
+
+    game_begin_tick(g);
+    for (n = g->zombie_pool.count - 1; n >= 0; n--) {
+        Zombie *z;
+
+        i = g->zombie_pool.live[n];
+        z = &g->zombies[i];
+        if (z->state != ZOMBIE_WALKING)
+            continue;
+        z->x -= ZOMBIE_SPEED;
+        if (tick % ZOMBIE_FRAMES_PER_UPDATE == 0 &&
+            ++z->animation_frame >= ZOMBIE_ROWS * ZOMBIE_COLS)
+            z->animation_frame = 0;
+        if (z->x + ZOMBIE_DISPLAY_WIDTH < 0)
+            POOL_FREE(&g->zombie_pool, i);
+    }
+}
+
+static void aos_peas(GameState *g, int tick)
+{
+    int n, i;
+
+    (void)tick;
+    game_begin_tick(g);
+    for (n = g->pea_pool.count - 1; n >= 0; n--) {
+        i = g->pea_pool.live[n];
+        g->peas[i].x += PEA_SPEED;
+        if (g->peas[i].x > SCREEN_WIDTH)
+            POOL_FREE(&g->pea_pool, i);
+    }
+}
+
+/* ============================================================ */
+/*                  COLLISION AND UPDATES                       */
+/* ============================================================ */
+
+/**
+ * The collision test before lanes: every pea against every zombie
+ */
+static void collide_all_pairs(GameState *g, int tick)
+{
+    int n, m, i, j;
+
+    (void)tick;
+    for (n = g->pea_pool.count - 1; n >= 0; n--) {
+        i = g->pea_pool.live[n];
+        for (m = 0; m < g->zombie_pool.count; m++) {
+            j = g->zombie_pool.live[m];
+            if (g->zombies[j].row != g->peas[i].row)
+                continue;
+            if (rects_overlap((int)g->peas[i].x, (int)g->peas[i].y, PEA_SIZE, PEA_SIZE,
+                              (int)g->zombies[j].x, (int)g->zombies[j].y + ZOMBIE_Y_OFFSET,
+                              ZOMBIE_DISPLAY_WIDTH, ZOMBIE_DISPLAY_HEIGHT)) {
+                POOL_FREE(&g->pea_pool, i);
+                break;
+            }
+        }
+    }
+}
+
+static void collide_lanes(GameState *g, int tick)
+{
+    (void)tick;
+    game_check_pea_zombie_collision(g);
+}
+
+static void update_suns(GameState *g, int tick)
+{
+    (void)tick;
+    game_begin_tick(g);
+    game_update_suns(g);
+}
+
+static void update_zombies(GameState *g, int tick)
+{
+    (void)tick;
+    game_begin_tick(g);
+    game_update_zombies(g);
+}
+
+static void update_peas(GameState *g, int tick)
+{
+    (void)tick;
+    game_begin_tick(g);
+    game_update_peas(g);
+}
+
+/* ============================================================ */
+/*                       SCENARIOS                              */
+/* ============================================================ */
+
+typedef enum {
+    KIND_SUNS,
+    KIND_ZOMBIES,
+    KIND_PEAS,
+    KIND_COLLIDE,
+    NUM_KINDS
+} EntityKind;
+
+typedef void (*TickFn)(GameState *g, int tick);
+
+static const struct {
+    const char *name;
+    TickFn soa, aos, update;
+} kinds[NUM_KINDS] = {
+    { "suns",    soa_suns,    aos_suns,          update_suns },
+    { "zombies", soa_zombies, aos_zombies,       update_zombies },
+    { "peas",    soa_peas,    aos_peas,          update_peas },
+    { "collide", NULL,        collide_all_pairs, collide_lanes },
+};
+
+/**
+ * Empty lawn with one pool full, copied into the structure of arrays
+ * Suns start high enough and peas far enough left to stay in flight
+ * for BENCH_TICKS ticks.
+ */
+static int seed(EntityKind kind)
+{
+    int i;
+
+    srand(1);
+    game_init(&seeded_state);
+    memset(&seeded_soa, 0, sizeof(seeded_soa));
+
+    for (i = 0; i < MAX_SUNS && kind == KIND_SUNS; i++) {
+        game_spawn_sun(&seeded_state, (i * 7) % (SCREEN_WIDTH - SUN_SIZE), i % 20);
+        seeded_soa.suns.x[i] = seeded_state.suns[i].x;
+        seeded_soa.suns.y[i] = seeded_state.suns[i].y;
+        seeded_soa.suns.vx[i] = seeded_state.suns[i].vx;
+        seeded_soa.suns.vy[i] = seeded_state.suns[i].vy;
+        seeded_soa.suns.ay[i] = SUN_GRAVITY;
+        seeded_soa.suns.lifetime[i] = seeded_state.suns[i].lifetime;
+        seeded_soa.sun_span = i + 1;
+    }
+    for (i = 0; i < MAX_ZOMBIES && (kind == KIND_ZOMBIES || kind == KIND_COLLIDE); i++) {
+        game_spawn_zombie(&seeded_state);
+        seeded_soa.zombies.x[i] = seeded_state.zombies[i].x;
+        seeded_soa.zombies.y[i] = seeded_state.zombies[i].y;
+        seeded_soa.zombies.vx[i] = -ZOMBIE_SPEED;
+        seeded_soa.zombies.state[i] = ZOMBIE_WALKING;
+        seeded_soa.zombies.animation_frame[i] = seeded_state.zombies[i].animation_frame;
+        seeded_soa.zombie_span = i + 1;
+    }
+    for (i = 0; i < MAX_PEAS && (kind == KIND_PEAS || kind == KIND_COLLIDE); i++) {
+        game_shoot_pea(&seeded_state, i % GRID_ROWS, i % 4);
+        seeded_soa.peas.x[i] = seeded_state.peas[i].x;
+        seeded_soa.peas.y[i] = seeded_state.peas[i].y;
+        seeded_soa.peas.vx[i] = PEA_SPEED;
+        seeded_soa.pea_span = i + 1;
+    }
+
+    switch (kind) {
+    case KIND_SUNS:    return seeded_state.sun_pool.count;
+    case KIND_ZOMBIES: return seeded_state.zombie_pool.count;
+    default:           return seeded_state.pea_pool.count;
+    }
+}
+
+/**
+ * Nanoseconds per entity per tick of one tick function
+ */
+static double time_ticks(TickFn fn, int entities, int reps)
+{
+    double busy = 0, t0;
+    int r, t;
+
+    for (r = 0; r < reps; r++) {
+        game = seeded_state;
+        soa = seeded_soa;
+        t0 = now_ns();
+        for (t = 0; t < BENCH_TICKS; t++)
+            fn(&game, t);
+        busy += now_ns() - t0;
+    }
+
+    return busy / ((double)reps * BENCH_TICKS * entities);
+}
+
+int main(int argc, char **argv)
+{
+    int reps = (argc > 1) ? atoi(argv[1]) : 200;
+    double ns_soa[NUM_KINDS], ns_aos[NUM_KINDS], ns_update[NUM_KINDS];
+    int count[NUM_KINDS];
+    int kind;
+
+    for (kind = 0; kind < NUM_KINDS; kind++) {
+        count[kind] = seed(kind);
+        ns_soa[kind] = kinds[kind].soa ? time_ticks(kinds[kind].soa, count[kind], reps) : 0.0;
+        ns_aos[kind] = time_ticks(kinds[kind].aos, count[kind], reps);
+        ns_update[kind] = time_ticks(kinds[kind].update, count[kind], reps);
+    }
+
+    printf("INFO: %d ticks x %d repetitions, pools full, ns per entity-tick (%s adds)\n",
+           BENCH_TICKS, reps, KERN_HAVE_NEON ? "NEON" : "scalar");
+    printf("INFO: movement, same work in both layouts\n");
+    for (kind = 0; kind < KIND_COLLIDE; kind++) {
+        printf("INFO:   %-8s %5d  structure of arrays %6.2f  array of structs %6.2f\n",
+               kinds[kind].name, count[kind], ns_soa[kind], ns_aos[kind]);
+    }
+    printf("INFO: pea collision, %d zombies\n", MAX_ZOMBIES);
+    printf("INFO:   %-8s %5d  sorted lanes        %6.2f  all pairs        %6.2f\n",
+           kinds[KIND_COLLIDE].name, count[KIND_COLLIDE], ns_update[KIND_COLLIDE], ns_aos[KIND_COLLIDE]);
+    printf("INFO: game update functions (movement, lanes, spatial grid)\n");
+    for (kind = 0; kind < KIND_COLLIDE; kind++)
+        printf("INFO:   %-8s %5d  %6.2f\n", kinds[kind].name, count[kind], ns_update[kind]);
+
+    return 0;
+}
+
+#endif // ENTITY_BENCH_HOST
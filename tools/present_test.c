@@ -0,0 +1,199 @@
+/* ------------------------------------------------------------ */
+/*               Present Queue Unit Test (host)                 */
+/* ------------------------------------------------------------ */
+/*
+ * Drives present.c the way the board does, with vsync_isr standing in
+ * for the VDMA frame-done interrupt: like VdmaReadIntrHandler it flips
+ * to the buffer present_on_vsync returns, and it records which buffer
+ * is on screen. The host takes no interrupts, so the test calls it
+ * between queue operations. Scripted sequences check ownership and the
+ * counters for triple and double buffering; then a long pseudo-random
+ * run of renders, releases and VSYNCs checks that the renderer is
+ * never handed the buffer on screen or the one waiting for the flip,
+ * and that every queued frame is either shown or dropped.
+ *
+ * Host only: the board build compiles this file to nothing. Build with
+ * the BSP include directory on the path:
+ *   gcc -O2 -DPRESENT_TEST_HOST -DPVZ_HOST_THREADS -I<bsp>/include -I. \
+ *       tools/present_test.c present.c -o present_test
+ *
+ * Usage: present_test    (exit status 0 when every check passes)
+ */
+#ifdef PRESENT_TEST_HOST
+
+#include "present.h"
+#include <stdio.h>
+
+#define RANDOM_STEPS   100000
+
+static int on_screen;    // buffer the display is scanning out
+
+/**
+ * VDMA frame done: flip to the newest queued frame, if any
+ */
+static int vsync_isr(void)
+{
+    int next = present_on_vsync();
+
+    if (next >= 0)
+        on_screen = next;
+    return next;
+}
+
+static void start(int count, int displayed_index)
+{
+    present_init(count, displayed_index);
+    on_screen = displayed_index;
+}
+
+static int check(int cond, const char *what)
+{
+    if (!cond)
+        printf("WARNING: present test failed: %s\n", what);
+    return !cond;
+}
+
+/* ============================================================ */
+/*                     SCRIPTED SEQUENCES                       */
+/* ============================================================ */
+
+/**
+ * Triple buffering: rendering never waits, newest frame wins
+ */
+static int test_triple(void)
+{
+    PresentStats s;
+    int errors = 0;
+    int a, b, c;
+
+    start(3, 0);
+    a = present_acquire();
+    errors += check(a == 1, "first free buffer");
+    present_queue(a);
+    b = present_acquire();
+    errors += check(b == 2, "render while a frame waits");
+    present_queue(b);
+    present_get_stats(&s);
+    errors += check(s.dropped == 1, "replaced frame counted as dropped");
+    c = present_acquire();
+    errors += check(c == 1, "dropped buffer is reused");
+    errors += check(vsync_isr() == 2 && on_screen == 2, "VSYNC flips to the newest frame");
+    present_release(c);
+    errors += check(present_acquire() == 0, "old scanout buffer handed back");
+    return errors;
+}
+
+/**
+ * A VSYNC with nothing queued makes the frame in flight late
+ */
+static int test_late(void)
+{
+    PresentStats s;
+    int errors = 0;
+    int a;
+
+    start(3, 0);
+    a = present_acquire();
+    errors += check(vsync_isr() == -1 && on_screen == 0, "nothing to flip");
+    present_queue(a);
+    present_get_stats(&s);
+    errors += check(s.late == 1, "missed VSYNC counted as late");
+    errors += check(vsync_isr() == a && on_screen == a, "late frame shown next VSYNC");
+    return errors;
+}
+
+/**
+ * Double buffering: the renderer has to wait for the flip
+ */
+static int test_double(void)
+{
+    int errors = 0;
+    int a;
+
+    start(2, 0);
+    a = present_acquire();
+    present_queue(a);
+    errors += check(present_acquire() == -1, "no free buffer until VSYNC");
+    errors += check(vsync_isr() == 1 && on_screen == 1, "queued frame shown");
+    errors += check(present_acquire() == 0, "front buffer freed by VSYNC");
+    return errors;
+}
+
+/* ============================================================ */
+/*                      RANDOM SEQUENCE                         */
+/* ============================================================ */
+
+/**
+ * Renders, releases and VSYNCs in pseudo-random order
+ */
+static int test_random(int count)
+{
+    PresentStats s;
+    u32 seed = 12345 + count;
+    int errors = 0, step;
+    int rendering = -1, waiting = -1;
+
+    start(count, 0);
+    for (step = 0; step < RANDOM_STEPS && errors < 10; step++) {
+        seed = seed * 1664525u + 1013904223u;
+
+        switch ((seed >> 16) % 4) {
+        case 0:
+            // The renderer gets back the buffer it holds, or a free one
+            if (rendering < 0) {
+                rendering = present_acquire();
+                errors += check(rendering != on_screen || rendering < 0, "buffer on screen handed out");
+                errors += check(rendering != waiting || rendering < 0, "queued buffer handed out");
+            }
+            break;
+        case 1:
+            if (rendering >= 0) {
+                present_queue(rendering);
+                waiting = rendering;
+                rendering = -1;
+            }
+            break;
+        case 2:
+            // Rarely: a frame is abandoned
+            if (rendering >= 0 && (seed >> 24) % 8 == 0) {
+                present_release(rendering);
+                rendering = -1;
+            }
+            break;
+        default:
+            if (vsync_isr() >= 0) {
+                errors += check(on_screen == waiting, "flip to the last queued frame");
+                waiting = -1;
+            }
+            break;
+        }
+    }
+
+    // Flush the last frame out, then every queued frame is accounted for
+    if (rendering >= 0)
+        present_release(rendering);
+    vsync_isr();
+    present_get_stats(&s);
+    errors += check(s.queued == s.shown + s.dropped, "queued frames shown or dropped");
+
+    printf("INFO: %d buffers: %lu queued, %lu shown, %lu dropped, %lu late, %lu vsyncs\n", count,
+           (unsigned long)s.queued, (unsigned long)s.shown, (unsigned long)s.dropped,
+           (unsigned long)s.late, (unsigned long)s.vsyncs);
+    return errors;
+}
+
+int main(void)
+{
+    int errors = 0;
+
+    errors += test_triple();
+    errors += test_late();
+    errors += test_double();
+    errors += test_random(3);
+    errors += test_random(2);
+
+    printf("INFO: present queue tests %s\n", errors ? "FAILED" : "passed");
+    return errors != 0;
+}
+
+#endif // PRESENT_TEST_HOST
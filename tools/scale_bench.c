@@ -0,0 +1,129 @@
+/* ------------------------------------------------------------ */
+/*              Scaled Blit Benchmark (host)                    */
+/* ------------------------------------------------------------ */
+/*
+ * Times draw_sprite_scaled, which walks cached source-index tables,
+ * against the scaled blit as it was before scale_table.c (two divides
+ * per output pixel) for the size pairs the game uses, checks that both
+ * draw the same pixels, and prints the time per output pixel. Given
+ * the CPU clock in MHz it prints cycles per output pixel as well.
+ *
+ * Host only: the board build compiles this file to nothing. Build with
+ * the BSP include directory on the path:
+ *   gcc -O2 -DSCALE_BENCH_HOST -DPVZ_HOST_THREADS -I<bsp>/include -I. \
+ *       tools/scale_bench.c pvz_game.c display_list.c clip.c rle_sprite.c \
+ *       sprite_cache.c scale_table.c blit_kernels.c damage.c plant_tiles.c \
+ *       entity_pool.c spatial_grid.c render_bands.c smp.c -o scale_bench -lpthread
+ *
+ * Usage: scale_bench [cpu MHz] [draws per size pair]
+ */
+#ifdef SCALE_BENCH_HOST
+
+#include "pvz_game.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Cache maintenance used by damage.c: nothing to flush on the host
+void Xil_DCacheFlushRange(INTPTR adr, u32 len) { (void)adr; (void)len; }
+void Xil_DCacheFlush(void) { }
+
+extern const unsigned char gImage_PeaShooter[];
+extern const unsigned char gImage_ZombiesWon_ani[];
+
+static u8 framebuf[SCREEN_WIDTH * SCREEN_HEIGHT * 3];
+static u8 divide_frame[SCREEN_WIDTH * SCREEN_HEIGHT * 3];
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * The scaled blit as it was before scaling tables: two divides per pixel
+ */
+static void scaled_divide(u8 *fb, int dst_x, int dst_y, int dst_w, int dst_h,
+                          const u8 *sprite_data, int src_w, int src_h)
+{
+    int i, j;
+
+    for (i = 0; i < dst_h; i++) {
+        for (j = 0; j < dst_w; j++) {
+            int src_x = (j * src_w) / dst_w;
+            int src_y = (i * src_h) / dst_h;
+            u32 fb_idx = ((dst_y + i) * SCREEN_WIDTH + (dst_x + j)) * 3;
+            u32 sprite_idx = (src_y * src_w + src_x) * 3;
+
+            fb[fb_idx]     = sprite_data[sprite_idx];
+            fb[fb_idx + 1] = sprite_data[sprite_idx + 1];
+            fb[fb_idx + 2] = sprite_data[sprite_idx + 2];
+        }
+    }
+}
+
+/**
+ * Nanoseconds per output pixel for one size pair
+ */
+static double time_scaled(int use_tables, int draws, const u8 *src,
+                          int src_w, int src_h, int dst_w, int dst_h)
+{
+    double t0;
+    int n;
+
+    t0 = now_ns();
+    for (n = 0; n < draws; n++) {
+        if (use_tables)
+            draw_sprite_scaled(framebuf, 0, 0, dst_w, dst_h, src, src_w, src_h, NULL);
+        else
+            scaled_divide(divide_frame, 0, 0, dst_w, dst_h, src, src_w, src_h);
+    }
+
+    return (now_ns() - t0) / ((double)draws * dst_w * dst_h);
+}
+
+int main(int argc, char **argv)
+{
+    static const struct {
+        const char *name;
+        const u8 *src;
+        int src_w, src_h, dst_w, dst_h;
+    } cases[] = {
+        { "card icon",      gImage_PeaShooter,     90,  90,  PLANT_ICON_SIZE, PLANT_ICON_SIZE },
+        { "plant",          gImage_PeaShooter,     90,  90,  PLANT_SIZE,      PLANT_SIZE },
+        { "defeat 0.5x",    gImage_ZombiesWon_ani, DEFEAT_IMAGE_WIDTH, DEFEAT_IMAGE_HEIGHT,
+                            DEFEAT_IMAGE_WIDTH / 2, DEFEAT_IMAGE_HEIGHT / 2 },
+        { "defeat 1.0x",    gImage_ZombiesWon_ani, DEFEAT_IMAGE_WIDTH, DEFEAT_IMAGE_HEIGHT,
+                            DEFEAT_IMAGE_WIDTH, DEFEAT_IMAGE_HEIGHT },
+    };
+    double mhz = (argc > 1) ? atof(argv[1]) : 0.0;
+    int draws = (argc > 2) ? atoi(argv[2]) : 200;
+    int errors = 0;
+    int i;
+
+    printf("INFO: %d draws per size pair, ns (cycles at %.0f MHz) per output pixel\n", draws, mhz);
+    printf("INFO:   %-12s %16s %16s\n", "size", "divide", "tables");
+
+    for (i = 0; i < (int)(sizeof(cases) / sizeof(cases[0])); i++) {
+        double before = time_scaled(0, draws, cases[i].src, cases[i].src_w, cases[i].src_h,
+                                    cases[i].dst_w, cases[i].dst_h);
+        double after = time_scaled(1, draws, cases[i].src, cases[i].src_w, cases[i].src_h,
+                                   cases[i].dst_w, cases[i].dst_h);
+
+        printf("INFO:   %-12s %7.2f (%6.2f) %7.2f (%6.2f)\n", cases[i].name,
+               before, before * mhz / 1000.0, after, after * mhz / 1000.0);
+
+        // Same pixels either way
+        if (memcmp(framebuf, divide_frame, sizeof(framebuf)) != 0) {
+            printf("WARNING: %s: table blit differs from the divide blit\n", cases[i].name);
+            errors++;
+        }
+    }
+
+    return errors != 0;
+}
+
+#endif // SCALE_BENCH_HOST
@@ -0,0 +1,320 @@
+/* ------------------------------------------------------------ */
+/*          Dual-Core Split Check and Benchmark (host)          */
+/* ------------------------------------------------------------ */
+/*
+ * Runs the PVZ_DUAL_CORE structure on a PC: the simulation publishes
+ * GameState snapshots from the main thread and a second thread (smp.c
+ * with PVZ_HOST_THREADS) renders them with the game's own damage and
+ * draw code. The same seeded scene is then run sequentially, and the
+ * last frames of the two runs are compared. Finally full and
+ * incremental frames are timed composed by one thread and in bands by
+ * two (render_bands.c), again comparing the last frames.
+ *
+ * Host only: the board build compiles this file to nothing. Build with
+ * the BSP include directory on the path (add -fsanitize=thread -g to
+ * check the snapshot hand-over with ThreadSanitizer):
+ *   gcc -O2 -DSMP_HOST_BENCH -DPVZ_HOST_THREADS -DPVZ_DUAL_CORE \
+ *       -I<bsp>/include -I. tools/smp_host.c snapshot.c smp.c \
+ *       render_bands.c pvz_game.c display_list.c \
+ *       clip.c rle_sprite.c sprite_cache.c scale_table.c blit_kernels.c \
+ *       damage.c plant_tiles.c entity_pool.c spatial_grid.c -o smp_host -lpthread
+ *
+ * Usage: smp_host [ticks] [tick period us]
+ * The split run paces the simulation at the tick period (default 1 ms,
+ * 10x the board's timer) so the renderer shows how many of the ticks it
+ * keeps up with; busy times are per thread.
+ */
+#ifdef SMP_HOST_BENCH
+
+#include "snapshot.h"
+#include "smp.h"
+#include "damage.h"
+#include "sprite_cache.h"
+#include "blit_kernels.h"
+#include "plant_tiles.h"
+#include "render_bands.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define HOST_BUFFERS   3
+#define FRAME_BYTES    (SCREEN_WIDTH * SCREEN_HEIGHT * 3)
+#define FULL_FRAMES    200
+
+// Cache maintenance used by damage.c: nothing to flush on the host
+void Xil_DCacheFlushRange(INTPTR adr, u32 len) { (void)adr; (void)len; }
+void Xil_DCacheFlush(void) { }
+
+static u8 frames[HOST_BUFFERS][FRAME_BYTES];
+static u8 sequential_last[FRAME_BYTES];
+
+static GameState seeded_state;
+static GameState game;
+static SnapshotBuffer snapshots;
+
+// Render thread state
+static int front = 0;
+static u32 rendered = 0;
+static double render_busy_ms = 0;
+static u32 sim_done = 0;
+
+// Band helper thread runs until this is set
+static u32 helper_stop = 0;
+
+static double now_ms(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+/**
+ * Fill the lawn and spawn zombies so every layer has work each frame
+ */
+static void seed_scene(GameState *g)
+{
+    int row, col, i;
+
+    srand(1);
+    game_init(g);
+    for (row = 0; row < GRID_ROWS; row++) {
+        for (col = 0; col < GRID_COLS; col++) {
+            game_set_plant(g, row, col, (col < 2) ? PLANT_SUNFLOWER : PLANT_PEASHOOTER);
+            g->grid[row][col].animation_frame = (row + col) % 4;
+        }
+    }
+
+    for (i = 0; i < MAX_ZOMBIES; i++)
+        game_spawn_zombie(g);
+}
+
+/**
+ * One fixed-timestep tick, same update order as the main loop
+ */
+static void simulate_tick(GameState *g)
+{
+    game_begin_tick(g);
+    game_update_gameover(g);
+    if (g->play_state == GAME_PLAYING) {
+        game_update_animation(g);
+        game_check_pea_zombie_collision(g);
+    }
+    game_update_peas(g);
+    game_update_suns(g);
+    game_update_zombies(g);
+}
+
+/**
+ * Render view into the next buffer, as render_step does on the board
+ */
+static void render_view(GameState *view)
+{
+    int back = (front + 1) % HOST_BUFFERS;
+    double t0 = now_ms();
+
+    damage_begin_frame(back);
+    if (game_damage_changes(view)) {
+        damage_sync_back_buffer(frames[back], frames[front], back);
+        game_draw_damage(view, frames[back]);
+        damage_end_frame(1);
+        front = back;
+    } else {
+        damage_end_frame(0);
+    }
+    rendered++;
+    render_busy_ms += now_ms() - t0;
+}
+
+/**
+ * Bring the renderer to a known state: every buffer drawn from the seed
+ */
+static void reset_renderer(void)
+{
+    int i;
+
+    for (i = 0; i < HOST_BUFFERS; i++)
+        game_draw_full(&game, frames[i]);
+    damage_init(HOST_BUFFERS);
+    front = 0;
+    rendered = 0;
+    render_busy_ms = 0;
+}
+
+/**
+ * Second thread: render every snapshot it gets until the simulation
+ * is done and the newest one has been drawn
+ */
+static void render_thread(void)
+{
+    GameState *view;
+
+    while (1) {
+        view = snapshot_acquire(&snapshots);
+        if (view) {
+            render_view(view);
+        } else if (__atomic_load_n(&sim_done, __ATOMIC_ACQUIRE)) {
+            view = snapshot_acquire(&snapshots);
+            if (view)
+                render_view(view);
+            return;
+        } else {
+            smp_wait();
+        }
+    }
+}
+
+/**
+ * Second thread in the band runs: compose bands whenever a job is open
+ */
+static void band_helper_thread(void)
+{
+    while (!__atomic_load_n(&helper_stop, __ATOMIC_ACQUIRE)) {
+        if (!bands_help())
+            smp_wait();
+    }
+}
+
+/**
+ * Milliseconds per full redraw of the seeded scene
+ */
+static double time_full_frames(void)
+{
+    double t0;
+    int i;
+
+    game = seeded_state;
+    t0 = now_ms();
+    for (i = 0; i < FULL_FRAMES; i++)
+        game_draw_full(&game, frames[i % HOST_BUFFERS]);
+    return (now_ms() - t0) / FULL_FRAMES;
+}
+
+/**
+ * Milliseconds per incremental frame over the seeded run; the last
+ * frame is left in frames[front]
+ */
+static double time_incremental_frames(int ticks)
+{
+    int t;
+
+    game = seeded_state;
+    reset_renderer();
+    srand(2);
+    for (t = 0; t < ticks; t++) {
+        simulate_tick(&game);
+        render_view(&game);
+    }
+    return render_busy_ms / ticks;
+}
+
+int main(int argc, char **argv)
+{
+    int ticks = (argc > 1) ? atoi(argv[1]) : 3000;
+    long period_ns = ((argc > 2) ? atol(argv[2]) : 1000) * 1000;
+    double t0, t1, seq_ms, par_ms, sim_busy_ms = 0;
+    double full_one, full_two, inc_one, inc_two;
+    struct timespec deadline;
+    u32 seq_frames;
+    int t, diff = 0;
+
+    kern_init();
+    sprite_cache_init(SPRITE_CACHE_LAZY);
+    plant_tile_init(1);
+    bands_init(0);
+
+    seed_scene(&seeded_state);
+
+    // Sequential: simulate and render one after the other
+    game = seeded_state;
+    reset_renderer();
+    srand(2);
+    t0 = now_ms();
+    for (t = 0; t < ticks; t++) {
+        simulate_tick(&game);
+        render_view(&game);
+    }
+    seq_ms = now_ms() - t0;
+    seq_frames = rendered;
+    memcpy(sequential_last, frames[front], FRAME_BYTES);
+
+    // Split: simulation here, rendering on the second thread
+    game = seeded_state;
+    reset_renderer();
+    snapshot_init(&snapshots, &game);
+    sim_done = 0;
+    srand(2);
+    t0 = now_ms();
+    if (smp_start_cpu1(render_thread) != 0)
+        return 1;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    for (t = 0; t < ticks; t++) {
+        t1 = now_ms();
+        simulate_tick(&game);
+        snapshot_publish(&snapshots, &game);
+        smp_signal();
+        sim_busy_ms += now_ms() - t1;
+
+        // Next timer tick
+        deadline.tv_nsec += period_ns;
+        while (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_nsec -= 1000000000L;
+            deadline.tv_sec++;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL);
+    }
+    __atomic_store_n(&sim_done, 1, __ATOMIC_RELEASE);
+    smp_signal();
+    smp_join_cpu1();
+    par_ms = now_ms() - t0;
+
+    for (t = 0; t < FRAME_BYTES; t++)
+        diff += frames[front][t] != sequential_last[t];
+
+    printf("INFO: %d ticks\n", ticks);
+    printf("INFO:   sequential  %8.1f ms busy, %6.3f ms/tick (simulate + render), %lu frames rendered\n",
+           seq_ms, seq_ms / ticks, (unsigned long)seq_frames);
+    printf("INFO:   split       %8.1f ms wall at %ld us/tick\n", par_ms, period_ns / 1000);
+    printf("INFO:     simulate  %8.1f ms busy, %6.3f ms/tick, %lu snapshots published\n",
+           sim_busy_ms, sim_busy_ms / ticks, (unsigned long)snapshots.published);
+    printf("INFO:     render    %8.1f ms busy, %6.3f ms/frame, %lu frames rendered\n",
+           render_busy_ms, rendered ? render_busy_ms / rendered : 0.0, (unsigned long)rendered);
+    if (diff)
+        printf("WARNING: last frames differ in %d bytes\n", diff);
+    else
+        printf("INFO: last frames identical\n");
+
+    // Bands: one thread composes every band, then two share them
+    full_one = time_full_frames();
+    inc_one = time_incremental_frames(ticks);
+    memcpy(sequential_last, frames[front], FRAME_BYTES);
+
+    helper_stop = 0;
+    if (smp_start_cpu1(band_helper_thread) != 0)
+        return 1;
+    bands_set_enabled(1);
+    full_two = time_full_frames();
+    inc_two = time_incremental_frames(ticks);
+    bands_set_enabled(0);
+    __atomic_store_n(&helper_stop, 1, __ATOMIC_RELEASE);
+    smp_signal();
+    smp_join_cpu1();
+
+    for (t = 0, diff = 0; t < FRAME_BYTES; t++)
+        diff += frames[front][t] != sequential_last[t];
+
+    printf("INFO: %d bands, %d full frames\n", BANDS_NUM, FULL_FRAMES);
+    printf("INFO:   full         one thread %6.3f ms  two %6.3f ms  speedup %.2fx\n",
+           full_one, full_two, full_one / full_two);
+    printf("INFO:   incremental  one thread %6.3f ms  two %6.3f ms  speedup %.2fx\n",
+           inc_one, inc_two, inc_one / inc_two);
+    if (diff)
+        printf("WARNING: banded last frame differs in %d bytes\n", diff);
+    else
+        printf("INFO: banded last frame identical\n");
+
+    return diff != 0;
+}
+
+#endif // SMP_HOST_BENCH